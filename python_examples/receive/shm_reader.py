@@ -0,0 +1,69 @@
+import mmap
+import struct
+import sys
+import time
+
+import numpy as np
+import matplotlib.pyplot as plt
+
+# Заголовок кольца SharedMemoryTap (см. src/DSP/README.md)
+HEADER = struct.Struct('<IHHIIQdd16xQQQ')
+MAGIC = 0x52585254
+VERSION = 2
+WRITE_BEGIN_OFFSET = 56
+WRITE_INDEX_OFFSET = 64
+
+
+class SharedRing:
+    def __init__(self, name):
+        path = '/dev/shm/' + name.lstrip('/')
+        with open(path, 'r+b') as f:
+            self.mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        (magic, version, data_offset, fmt, bytes_per_sample, capacity,
+         self.sample_rate, self.frequency, _, _, _) = HEADER.unpack_from(self.mm)
+        if magic != MAGIC:
+            raise ValueError('bad magic')
+        if version != VERSION:
+            raise ValueError(f'unsupported version {version}')
+        self.capacity = capacity
+        dtype = np.int16 if fmt == 0 else np.float32
+        # Данные без копирования: [capacity, 2] (I, Q)
+        self.ring = np.frombuffer(self.mm, dtype=dtype, count=capacity * 2,
+                                  offset=data_offset).reshape(-1, 2)
+
+    def write_index(self):
+        return struct.unpack_from('<Q', self.mm, WRITE_INDEX_OFFSET)[0]
+
+    def write_begin(self):
+        return struct.unpack_from('<Q', self.mm, WRITE_BEGIN_OFFSET)[0]
+
+    def latest(self, count):
+        """Последние `count` отсчётов. Читатель никогда не блокирует
+        писателя: если данные перезаписаны во время копирования,
+        возвращается только уцелевшая часть."""
+        w1 = self.write_index()
+        count = min(count, self.capacity, w1)
+        start = w1 - count
+        idx = np.arange(start, w1) % self.capacity
+        out = self.ring[idx].copy()
+        # writeBegin учитывает и запись, которая шла во время копирования
+        b2 = self.write_begin()
+        lost = min(count, max(0, b2 - self.capacity - start))
+        return out[lost:]
+
+
+name = sys.argv[1] if len(sys.argv) > 1 else '/trx_sdr1'
+ring = SharedRing(name)
+print(f'capacity: {ring.capacity}, fs: {ring.sample_rate}, f: {ring.frequency}')
+
+plt.ion()
+fig, ax = plt.subplots(figsize=(12, 6))
+while True:
+    iq = ring.latest(4096).astype(np.float32)
+    ax.clear()
+    ax.plot(iq[:, 0], label='I', alpha=0.7)
+    ax.plot(iq[:, 1], label='Q', alpha=0.7)
+    ax.legend()
+    ax.grid(True)
+    plt.pause(0.05)
+    time.sleep(0.05)
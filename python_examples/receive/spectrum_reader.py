@@ -0,0 +1,60 @@
+import os
+import socket
+import struct
+import sys
+
+import numpy as np
+import matplotlib.pyplot as plt
+
+# Заголовок кадра SpectrumTap (см. src/DSP/README.md)
+HEADER = struct.Struct('<IHHIIQQdd')
+MAGIC = 0x53585254
+
+
+def parse_frame(buf):
+    magic, version, header_size, bins, averages, seq, ts, fc, fs = HEADER.unpack_from(buf)
+    if magic != MAGIC:
+        raise ValueError('bad magic')
+    psd = np.frombuffer(buf, dtype=np.float32, count=bins, offset=header_size)
+    freqs = fc + (np.arange(bins) - bins // 2) * fs / bins
+    return seq, ts, freqs, psd
+
+
+def read_file(filename):
+    with open(filename, 'rb') as f:
+        data = f.read()
+    offset = 0
+    while offset + HEADER.size <= len(data):
+        bins = HEADER.unpack_from(data, offset)[3]
+        size = HEADER.size + bins * 4
+        yield parse_frame(data[offset:offset + size])
+        offset += size
+
+
+def read_socket(path):
+    if os.path.exists(path):
+        os.unlink(path)
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM)
+    sock.bind(path)
+    while True:
+        yield parse_frame(sock.recv(1 << 20))
+
+
+source = sys.argv[1] if len(sys.argv) > 1 else '/tmp/trx_spectrum.sock'
+frames = read_file(source) if os.path.isfile(source) else read_socket(source)
+
+plt.ion()
+fig, ax = plt.subplots(figsize=(12, 6))
+line = None
+for seq, ts, freqs, psd in frames:
+    if line is None:
+        line, = ax.plot(freqs / 1e6, psd)
+        ax.set_xlabel('Частота, МГц')
+        ax.set_ylabel('СПМ, дБ/Гц')
+        ax.grid(True)
+    else:
+        line.set_ydata(psd)
+    ax.set_title(f'Кадр {seq}, t = {ts} нс')
+    ax.relim()
+    ax.autoscale_view()
+    plt.pause(0.01)
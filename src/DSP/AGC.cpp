@@ -0,0 +1,124 @@
+#include "AGC.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dsp {
+
+namespace {
+
+float dbToLinear(float db) { return std::pow(10.0f, db / 20.0f); }
+
+}  // namespace
+
+template <Sample T>
+AGC<T>::AGC(const SDRcfg::SDRConfig& sdrConfig, const AGCConfig& cfg)
+    : cfg(cfg),
+      gainMode(sdrConfig.gainMode),
+      sampleRate(sdrConfig.rxSampleRate),
+      attackTime(0.0f),
+      decayTime(0.0f),
+      minGain(dbToLinear(cfg.minGainDb)),
+      maxGain(dbToLinear(cfg.maxGainDb)),
+      envelope(cfg.targetLevel),
+      gain(1.0f),
+      hardwareGain(sdrConfig.gain) {
+    switch (gainMode) {
+        case SDRcfg::GainMode::Manual:
+            return;
+        case SDRcfg::GainMode::SlowAttack:
+            attackTime = cfg.slowAttackTime;
+            decayTime = cfg.slowDecayTime;
+            break;
+        case SDRcfg::GainMode::FastAttack:
+            attackTime = cfg.fastAttackTime;
+            decayTime = cfg.fastDecayTime;
+            break;
+        default:
+            throw std::invalid_argument("Unsupported gain mode for AGC");
+    }
+    if (sampleRate <= 0.0) {
+        throw std::invalid_argument("AGC requires a positive RX sample rate");
+    }
+    if (attackTime <= 0.0f || decayTime <= 0.0f || cfg.targetLevel <= 0.0f) {
+        throw std::invalid_argument(
+            "AGC time constants and target level must be positive");
+    }
+}
+
+template <Sample T>
+void AGC<T>::setHardwareGainCallback(HardwareGainCallback callback) {
+    hardwareGainCallback = std::move(callback);
+}
+
+template <Sample T>
+float AGC<T>::gainDb() const { return 20.0f * std::log10(gain); }
+
+template <Sample T>
+float AGC<T>::nextGain(float blockPower, size_t samples) {
+    float rms = std::sqrt(blockPower);
+    float tau = rms > envelope ? attackTime : decayTime;
+    float alpha = 1.0f - std::exp(-static_cast<float>(
+                             static_cast<double>(samples) /
+                             (static_cast<double>(tau) * sampleRate)));
+    envelope += alpha * (rms - envelope);
+
+    float target = envelope > 1e-9f ? cfg.targetLevel / envelope : maxGain;
+    target = std::clamp(target, minGain, maxGain);
+    gain = target;
+
+    float targetDb = 20.0f * std::log10(target);
+    if (hardwareGainCallback && std::fabs(targetDb) > cfg.hardwareStepDb) {
+        double desired = hardwareGain + std::round(targetDb);
+        desired = std::clamp(desired, cfg.hardwareMinGainDb,
+                             cfg.hardwareMaxGainDb);
+        float applied = static_cast<float>(desired - hardwareGain);
+        if (applied != 0.0f) {
+            hardwareGain = desired;
+            hardwareGainCallback(hardwareGain);
+            // Следующие блоки придут уже с новым аппаратным усилением.
+            float scale = dbToLinear(applied);
+            envelope *= scale;
+            gain = std::clamp(target / scale, minGain, maxGain);
+        }
+    }
+    return target;
+}
+
+template <Sample T>
+void AGC<T>::process(T* iq, size_t samples) {
+    if (gainMode == SDRcfg::GainMode::Manual || samples == 0) {
+        return;
+    }
+    using Traits = SampleTraits<T>;
+    auto* data = scalars(iq);
+    float sumSquares = sumOfSquares(iq, samples);
+    float power = sumSquares / static_cast<float>(samples);
+
+    float g0 = gain;
+    float g1 = nextGain(power, samples);
+    float step = (g1 - g0) / static_cast<float>(samples);
+    for (size_t k = 0; k < samples; ++k) {
+        float g = g0 + step * static_cast<float>(k);
+        if constexpr (Traits::isFixedPoint) {
+            float re = std::clamp(static_cast<float>(data[2 * k]) * g,
+                                  -32768.0f, 32767.0f);
+            float im = std::clamp(static_cast<float>(data[2 * k + 1]) * g,
+                                  -32768.0f, 32767.0f);
+            data[2 * k] =
+                static_cast<int16_t>(re + (re >= 0.0f ? 0.5f : -0.5f));
+            data[2 * k + 1] =
+                static_cast<int16_t>(im + (im >= 0.0f ? 0.5f : -0.5f));
+        } else {
+            data[2 * k] *= g;
+            data[2 * k + 1] *= g;
+        }
+    }
+}
+
+template class AGC<int16_t>;
+template class AGC<float>;
+template class AGC<cf32>;
+
+}  // namespace dsp
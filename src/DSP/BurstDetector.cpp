@@ -0,0 +1,250 @@
+#include "BurstDetector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dsp {
+
+namespace {
+
+// Уровень шума снижается быстрее, чем растёт: кратковременный провал
+// мощности почти всегда означает шум, а рост — возможное начало пакета.
+constexpr float kFloorDecayBoost = 8.0f;
+
+float dbToPowerRatio(float db) { return std::pow(10.0f, db / 10.0f); }
+
+}  // namespace
+
+template <Sample T>
+BurstDetector<T>::BurstDetector(double sampleRate, SegmentCallback callback,
+                                const BurstDetectorConfig& cfg)
+    : cfg(cfg),
+      sampleRate(sampleRate),
+      callback(std::move(callback)),
+      onRatio(dbToPowerRatio(cfg.onThresholdDb)),
+      offRatio(dbToPowerRatio(cfg.offThresholdDb)),
+      floorAlpha(0.0f),
+      maxBurstSamples(0) {
+    if (sampleRate <= 0.0) {
+        throw std::invalid_argument(
+            "Burst detector requires a positive sample rate");
+    }
+    if (!this->callback) {
+        throw std::invalid_argument("Burst detector requires a callback");
+    }
+    if (cfg.blockLength == 0 || cfg.windowBlocks == 0) {
+        throw std::invalid_argument(
+            "Burst detector block and window lengths must be positive");
+    }
+    if (cfg.offThresholdDb > cfg.onThresholdDb) {
+        throw std::invalid_argument(
+            "Burst detector off threshold must not exceed on threshold");
+    }
+    if (cfg.noiseFloorTime <= 0.0f) {
+        throw std::invalid_argument(
+            "Burst detector noise floor time must be positive");
+    }
+    if (cfg.maxBurstTime < 0.0f) {
+        throw std::invalid_argument(
+            "Burst detector max burst time must not be negative");
+    }
+    maxBurstSamples = static_cast<uint64_t>(
+        std::llround(static_cast<double>(cfg.maxBurstTime) * sampleRate));
+    floorAlpha = std::min(
+        1.0f, static_cast<float>(static_cast<double>(cfg.blockLength) /
+                                 (static_cast<double>(cfg.noiseFloorTime) *
+                                  sampleRate)));
+    blockPowers.resize(cfg.windowBlocks);
+    history.resize(bufferLength<T>(cfg.preTrigger + cfg.blockLength));
+    reset();
+}
+
+template <Sample T>
+void BurstDetector<T>::reset() {
+    std::fill(blockPowers.begin(), blockPowers.end(), 0.0f);
+    blockCursor = 0;
+    blocksSeen = 0;
+    blockAccumulator = 0.0f;
+    blockFill = 0;
+    noiseFloor = 0.0f;
+    active = false;
+    hangover = 0;
+    burstStart = 0;
+    emittedUntil = 0;
+    lastSnr = 1.0f;
+    historySamples = 0;
+    totalSamples = 0;
+    forwardedSamples = 0;
+    burstCount = 0;
+    timestampSample = 0;
+    timestampBaseNs = 0;
+}
+
+template <Sample T>
+float BurstDetector<T>::noiseFloorDb() const {
+    return 10.0f * std::log10(std::max(noiseFloor, 1e-20f));
+}
+
+template <Sample T>
+float BurstDetector<T>::snrDb() const {
+    return 10.0f * std::log10(std::max(lastSnr, 1e-20f));
+}
+
+template <Sample T>
+int64_t BurstDetector<T>::timestampOf(uint64_t sample) const {
+    double offset = static_cast<double>(static_cast<int64_t>(sample) -
+                                        static_cast<int64_t>(timestampSample));
+    return timestampBaseNs + std::llround(offset * 1e9 / sampleRate);
+}
+
+template <Sample T>
+void BurstDetector<T>::push(const T* iq, size_t samples, int64_t timestampNs) {
+    uint64_t bufferStart = totalSamples;
+    timestampSample = bufferStart;
+    timestampBaseNs = timestampNs;
+
+    size_t pos = 0;
+    while (pos < samples) {
+        size_t take = std::min(cfg.blockLength - blockFill, samples - pos);
+        blockAccumulator += sumOfSquares(iq + bufferLength<T>(pos), take);
+        blockFill += take;
+        pos += take;
+        if (blockFill == cfg.blockLength) {
+            completeBlock(iq, bufferStart, pos);
+        }
+    }
+    // Пока пакет длится, остаток буфера уходит одним отрезком.
+    if (active && emittedUntil < bufferStart + samples) {
+        emit(iq, bufferStart, emittedUntil, bufferStart + samples, false,
+             false);
+    }
+    saveHistory(iq, samples);
+    totalSamples += samples;
+}
+
+template <Sample T>
+void BurstDetector<T>::completeBlock(const T* iq, uint64_t bufferStart,
+                                     size_t end) {
+    blockPowers[blockCursor] =
+        blockAccumulator / static_cast<float>(cfg.blockLength);
+    blockCursor = (blockCursor + 1) % cfg.windowBlocks;
+    blockAccumulator = 0.0f;
+    blockFill = 0;
+    ++blocksSeen;
+
+    size_t filled = std::min(blocksSeen, cfg.windowBlocks);
+    float windowPower = 0.0f;
+    for (size_t i = 0; i < filled; ++i) {
+        windowPower += blockPowers[i];
+    }
+    windowPower /= static_cast<float>(filled);
+
+    if (blocksSeen <= cfg.windowBlocks) {
+        noiseFloor = windowPower;  // Начальная оценка по первому окну
+        return;
+    }
+    float floor = std::max(noiseFloor, 1e-20f);
+    lastSnr = windowPower / floor;
+    uint64_t blockEnd = bufferStart + end;
+
+    if (!active) {
+        if (windowPower > floor * onRatio) {
+            active = true;
+            hangover = cfg.postTrigger;
+            ++burstCount;
+            // Предыстория: preTrigger отсчётов до начала блока, но не
+            // раньше конца предыдущего пакета и доступной истории.
+            uint64_t blockStart = blockEnd - cfg.blockLength;
+            uint64_t from = blockStart > cfg.preTrigger
+                                ? blockStart - cfg.preTrigger
+                                : 0;
+            from = std::max({from, emittedUntil, bufferStart - historySamples});
+            burstStart = from;
+            emit(iq, bufferStart, from, blockEnd, true, false);
+            return;
+        }
+        float alpha = windowPower < noiseFloor
+                          ? std::min(1.0f, kFloorDecayBoost * floorAlpha)
+                          : floorAlpha;
+        noiseFloor += alpha * (windowPower - noiseFloor);
+        return;
+    }
+
+    if (windowPower >= floor * offRatio) {
+        hangover = cfg.postTrigger;
+    } else {
+        hangover = hangover > cfg.blockLength ? hangover - cfg.blockLength : 0;
+    }
+    bool tooLong =
+        maxBurstSamples > 0 && blockEnd - burstStart >= maxBurstSamples;
+    if (hangover == 0 || tooLong) {
+        emit(iq, bufferStart, emittedUntil, blockEnd, false, true);
+        active = false;
+        if (hangover > 0) {
+            // Шум вырос: новый уровень — текущее окно.
+            noiseFloor = windowPower;
+            hangover = 0;
+        }
+    }
+}
+
+template <Sample T>
+void BurstDetector<T>::emit(const T* iq, uint64_t bufferStart, uint64_t from,
+                            uint64_t to, bool begin, bool end) {
+    size_t count = static_cast<size_t>(to - from);
+    const T* data = iq + bufferLength<T>(static_cast<size_t>(
+                             std::max(from, bufferStart) - bufferStart));
+    if (from < bufferStart) {
+        // Отрезок начинается в предыдущих буферах: склеиваем с историей.
+        size_t fromHistory = static_cast<size_t>(bufferStart - from);
+        size_t fromBuffer = count - fromHistory;
+        scratch.resize(bufferLength<T>(count));
+        std::copy_n(history.data() +
+                        bufferLength<T>(historySamples - fromHistory),
+                    bufferLength<T>(fromHistory), scratch.data());
+        std::copy_n(iq, bufferLength<T>(fromBuffer),
+                    scratch.data() + bufferLength<T>(fromHistory));
+        data = scratch.data();
+    }
+    BurstSegment segment{burstCount - 1, from, timestampOf(from),
+                         begin,          end,  snrDb()};
+    callback(data, count, segment);
+    forwardedSamples += count;
+    emittedUntil = to;
+}
+
+template <Sample T>
+void BurstDetector<T>::saveHistory(const T* iq, size_t samples) {
+    size_t capacity = cfg.preTrigger + cfg.blockLength;
+    if (samples >= capacity) {
+        std::copy_n(iq + bufferLength<T>(samples - capacity),
+                    bufferLength<T>(capacity), history.data());
+        historySamples = capacity;
+        return;
+    }
+    size_t keep = std::min(historySamples, capacity - samples);
+    std::copy_n(history.data() + bufferLength<T>(historySamples - keep),
+                bufferLength<T>(keep), history.data());
+    std::copy_n(iq, bufferLength<T>(samples),
+                history.data() + bufferLength<T>(keep));
+    historySamples = keep + samples;
+}
+
+template <Sample T>
+void BurstDetector<T>::flush() {
+    if (!active) {
+        return;
+    }
+    // Все отсчёты уже переданы, остаётся только закрыть пакет.
+    BurstSegment segment{burstCount - 1, emittedUntil,
+                         timestampOf(emittedUntil), false, true, snrDb()};
+    callback(scratch.data(), 0, segment);
+    active = false;
+}
+
+template class BurstDetector<int16_t>;
+template class BurstDetector<float>;
+template class BurstDetector<cf32>;
+
+}  // namespace dsp
@@ -0,0 +1,41 @@
+#include "CarrierRecovery.hpp"
+
+#include <cmath>
+#include <numbers>
+
+namespace dsp {
+
+CostasLoop::CostasLoop(const CarrierRecoveryConfig& cfg) {
+    float zeta = cfg.damping;
+    float theta = cfg.loopBandwidth / (zeta + 0.25f / zeta);
+    float denominator = 1.0f + 2.0f * zeta * theta + theta * theta;
+    kp = 4.0f * zeta * theta / denominator;
+    ki = 4.0f * theta * theta / denominator;
+    reset();
+}
+
+void CostasLoop::reset() {
+    phaseEstimate = 0.0f;
+    frequencyEstimate = 0.0f;
+}
+
+void CostasLoop::process(cf32* symbols, size_t count) {
+    constexpr float kTwoPi = 2.0f * std::numbers::pi_v<float>;
+    for (size_t i = 0; i < count; ++i) {
+        cf32 y = symbols[i] * std::polar(1.0f, -phaseEstimate);
+        symbols[i] = y;
+        float magnitude = std::abs(y);
+        if (magnitude < 1e-12f) {
+            continue;
+        }
+        // Решающий детектор фазы для QPSK, нормированный по амплитуде.
+        float err = (std::copysign(1.0f, y.real()) * y.imag() -
+                     std::copysign(1.0f, y.imag()) * y.real()) /
+                    magnitude;
+        frequencyEstimate += ki * err;
+        phaseEstimate += kp * err + frequencyEstimate;
+        phaseEstimate = std::remainder(phaseEstimate, kTwoPi);
+    }
+}
+
+}  // namespace dsp
@@ -0,0 +1,374 @@
+#include "DSPPlan.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "FIRFilter.hpp"
+
+namespace dsp {
+
+namespace {
+
+constexpr uint32_t PLAN_MAGIC = 0x50585254;  // "TRXP"
+constexpr uint32_t PLAN_VERSION = 2;
+constexpr size_t PLAN_ALIGNMENT = 64;
+
+// Заголовок файла плана. Смещения — от начала файла, каждая секция
+// выровнена на PLAN_ALIGNMENT и лежит после заголовка. Контрольная
+// сумма — по всему образу, включая заголовок с обнулённым полем checksum.
+struct PlanFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t fileSize;
+    uint64_t checksum;
+    BufferGeometry geometry;
+    uint64_t rxTapsOffset;
+    uint64_t rxTapCount;
+    uint64_t txTapsOffset;
+    uint64_t txTapCount;
+    uint64_t fftSize;
+    uint64_t twiddlesOffset;
+    uint64_t bitReverseOffset;
+};
+
+constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+
+uint64_t fnv1a(const uint8_t* data, size_t size, uint64_t hash = kFnvOffset) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+uint64_t fnv1a(uint64_t value, uint64_t hash) {
+    uint8_t bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    return fnv1a(bytes, sizeof(bytes), hash);
+}
+
+size_t alignUp(size_t n) {
+    return (n + PLAN_ALIGNMENT - 1) & ~(PLAN_ALIGNMENT - 1);
+}
+
+uint64_t poolBuffers(double sampleRate, double poolTime, size_t bufferSize) {
+    double buffers = std::ceil(poolTime * sampleRate /
+                               static_cast<double>(bufferSize));
+    return std::bit_ceil(
+        std::max<uint64_t>(2, static_cast<uint64_t>(std::max(buffers, 0.0))));
+}
+
+// Канальный ФНЧ под полосу `bandwidth`. Длина по оценке для окна
+// Хэмминга N ≈ 3.3 / Δf, где Δf — ширина переходной полосы до
+// ближайшего края (нуля или частоты Найквиста).
+std::vector<float> channelTaps(double bandwidth, double sampleRate,
+                               size_t maxTaps) {
+    if (bandwidth <= 0.0 || bandwidth >= sampleRate) {
+        return {1.0f};
+    }
+    double cutoff = bandwidth / (2.0 * sampleRate);
+    double transition = std::min(cutoff, 0.5 - cutoff);
+    size_t limit = maxTaps % 2 == 0 ? maxTaps - 1 : maxTaps;
+    double wanted = std::ceil(3.3 / transition);
+    size_t length = wanted >= static_cast<double>(limit)
+                        ? limit
+                        : static_cast<size_t>(wanted) | 1;
+    return FIRFilter::lowPass(cutoff, length);
+}
+
+// Память скомпилированного (не отображённого) образа. Слова по 8 байт
+// дают выравнивание, достаточное для всех секций.
+struct ImageBuffer {
+    std::vector<uint64_t> words;
+};
+
+struct MappedFile {
+    MappedFile(void* address, size_t size) : address(address), size(size) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { ::munmap(address, size); }
+
+    void* address;
+    size_t size;
+};
+
+struct Section {
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+template <typename T>
+bool sectionFits(uint64_t offset, uint64_t count, size_t fileSize) {
+    return offset % PLAN_ALIGNMENT == 0 &&
+           offset >= alignUp(sizeof(PlanFileHeader)) && offset <= fileSize &&
+           count <= (fileSize - offset) / sizeof(T);
+}
+
+// Секции не должны перекрываться (границы уже проверены sectionFits).
+bool sectionsDisjoint(std::array<Section, 4> sections) {
+    std::sort(sections.begin(), sections.end(),
+              [](const Section& a, const Section& b) {
+                  return a.offset < b.offset;
+              });
+    for (size_t i = 1; i < sections.size(); ++i) {
+        if (sections[i - 1].offset + sections[i - 1].bytes >
+            sections[i].offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t imageChecksum(const uint8_t* data, size_t size) {
+    PlanFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    header.checksum = 0;
+    uint64_t hash = fnv1a(reinterpret_cast<const uint8_t*>(&header),
+                          sizeof(header));
+    return fnv1a(data + sizeof(header), size - sizeof(header), hash);
+}
+
+}  // namespace
+
+uint64_t DSPPlan::keyOf(const SDRcfg::SDRConfig& sdrConfig,
+                        const DSPPlanOptions& options) {
+    uint64_t hash = fnv1a(PLAN_VERSION, kFnvOffset);
+    for (double value : {sdrConfig.rxSampleRate, sdrConfig.rxBandwidth,
+                         sdrConfig.txSampleRate, sdrConfig.txBandwidth,
+                         options.bufferPoolTime}) {
+        hash = fnv1a(std::bit_cast<uint64_t>(value), hash);
+    }
+    for (size_t value :
+         {sdrConfig.bufferSize, options.fftSize, options.maxChannelTaps}) {
+        hash = fnv1a(static_cast<uint64_t>(value), hash);
+    }
+    return hash;
+}
+
+std::shared_ptr<const DSPPlan> DSPPlan::compile(
+    const SDRcfg::SDRConfig& sdrConfig, const DSPPlanOptions& options) {
+    if (sdrConfig.rxSampleRate <= 0.0) {
+        throw std::invalid_argument("DSP plan requires a positive RX rate");
+    }
+    if (sdrConfig.bufferSize == 0) {
+        throw std::invalid_argument("DSP plan requires a non-zero buffer");
+    }
+    if (options.maxChannelTaps == 0) {
+        throw std::invalid_argument("DSP plan requires at least one tap");
+    }
+    bool hasTx = sdrConfig.txSampleRate > 0.0;
+    std::vector<float> rxTaps = channelTaps(
+        sdrConfig.rxBandwidth, sdrConfig.rxSampleRate, options.maxChannelTaps);
+    std::vector<float> txTaps =
+        hasTx ? channelTaps(sdrConfig.txBandwidth, sdrConfig.txSampleRate,
+                            options.maxChannelTaps)
+              : std::vector<float>{1.0f};
+    // Таблицы берутся из общего кэша (или считаются один раз).
+    std::shared_ptr<const FFTPlan> fft = FFTPlan::get(options.fftSize);
+
+    PlanFileHeader header{};
+    header.magic = PLAN_MAGIC;
+    header.version = PLAN_VERSION;
+    header.key = keyOf(sdrConfig, options);
+    header.geometry = BufferGeometry{
+        sdrConfig.bufferSize,
+        poolBuffers(sdrConfig.rxSampleRate, options.bufferPoolTime,
+                    sdrConfig.bufferSize),
+        hasTx ? poolBuffers(sdrConfig.txSampleRate, options.bufferPoolTime,
+                            sdrConfig.bufferSize)
+              : 0};
+    header.rxTapCount = rxTaps.size();
+    header.txTapCount = txTaps.size();
+    header.fftSize = options.fftSize;
+
+    size_t offset = alignUp(sizeof(PlanFileHeader));
+    header.rxTapsOffset = offset;
+    offset = alignUp(offset + rxTaps.size() * sizeof(float));
+    header.txTapsOffset = offset;
+    offset = alignUp(offset + txTaps.size() * sizeof(float));
+    header.twiddlesOffset = offset;
+    offset = alignUp(offset + options.fftSize / 2 * sizeof(cf32));
+    header.bitReverseOffset = offset;
+    offset = alignUp(offset + options.fftSize * sizeof(uint32_t));
+    header.fileSize = offset;
+
+    auto buffer = std::make_shared<ImageBuffer>();
+    buffer->words.resize(offset / sizeof(uint64_t));
+    auto* image = reinterpret_cast<uint8_t*>(buffer->words.data());
+    std::memcpy(image + header.rxTapsOffset, rxTaps.data(),
+                rxTaps.size() * sizeof(float));
+    std::memcpy(image + header.txTapsOffset, txTaps.data(),
+                txTaps.size() * sizeof(float));
+    std::memcpy(image + header.twiddlesOffset, fft->twiddleTable(),
+                options.fftSize / 2 * sizeof(cf32));
+    std::memcpy(image + header.bitReverseOffset, fft->bitReverseTable(),
+                options.fftSize * sizeof(uint32_t));
+    std::memcpy(image, &header, sizeof(header));
+    header.checksum = imageChecksum(image, offset);
+    std::memcpy(image, &header, sizeof(header));
+
+    auto plan = fromImage(buffer, image, offset, header.key, false);
+    if (!plan) {
+        throw std::logic_error("Compiled DSP plan failed validation");
+    }
+    return plan;
+}
+
+std::shared_ptr<const DSPPlan> DSPPlan::fromImage(
+    std::shared_ptr<const void> storage, const uint8_t* data, size_t size,
+    uint64_t expectedKey, bool fromCache) {
+    if (size < sizeof(PlanFileHeader)) {
+        return nullptr;
+    }
+    PlanFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != PLAN_MAGIC || header.version != PLAN_VERSION ||
+        header.key != expectedKey || header.fileSize != size) {
+        return nullptr;
+    }
+    size_t fftSize = static_cast<size_t>(header.fftSize);
+    if (fftSize < 2 || !std::has_single_bit(fftSize) ||
+        header.rxTapCount == 0 || header.txTapCount == 0 ||
+        header.geometry.samplesPerBuffer == 0 ||
+        !sectionFits<float>(header.rxTapsOffset, header.rxTapCount, size) ||
+        !sectionFits<float>(header.txTapsOffset, header.txTapCount, size) ||
+        !sectionFits<cf32>(header.twiddlesOffset, fftSize / 2, size) ||
+        !sectionFits<uint32_t>(header.bitReverseOffset, fftSize, size) ||
+        !sectionsDisjoint(
+            {Section{header.rxTapsOffset, header.rxTapCount * sizeof(float)},
+             Section{header.txTapsOffset, header.txTapCount * sizeof(float)},
+             Section{header.twiddlesOffset, fftSize / 2 * sizeof(cf32)},
+             Section{header.bitReverseOffset,
+                     fftSize * sizeof(uint32_t)}})) {
+        return nullptr;
+    }
+    if (imageChecksum(data, size) != header.checksum) {
+        return nullptr;
+    }
+
+    std::shared_ptr<DSPPlan> plan(new DSPPlan());
+    plan->bytes = std::span<const uint8_t>(data, size);
+    plan->planKey = header.key;
+    plan->bufferGeometry = header.geometry;
+    plan->rxTaps = std::span<const float>(
+        reinterpret_cast<const float*>(data + header.rxTapsOffset),
+        static_cast<size_t>(header.rxTapCount));
+    plan->txTaps = std::span<const float>(
+        reinterpret_cast<const float*>(data + header.txTapsOffset),
+        static_cast<size_t>(header.txTapCount));
+    plan->fft = FFTPlan::preload(std::make_shared<const FFTPlan>(
+        fftSize, reinterpret_cast<const cf32*>(data + header.twiddlesOffset),
+        reinterpret_cast<const uint32_t*>(data + header.bitReverseOffset),
+        storage));
+    plan->storage = std::move(storage);
+    plan->cached = fromCache;
+    return plan;
+}
+
+DSPPlanCache::DSPPlanCache(std::string directory,
+                           const DSPPlanOptions& options)
+    : directory(std::move(directory)), options(options) {}
+
+std::string DSPPlanCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.plan",
+                  static_cast<unsigned long long>(key));
+    return directory + "/" + name;
+}
+
+std::shared_ptr<const DSPPlan> DSPPlanCache::get(
+    const SDRcfg::SDRConfig& sdrConfig) {
+    uint64_t key = DSPPlan::keyOf(sdrConfig, options);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = plans.find(key);
+    if (it != plans.end()) {
+        ++hitCount;
+        return it->second;
+    }
+    std::string path = pathFor(key);
+    std::shared_ptr<const DSPPlan> plan = load(path, key);
+    if (plan) {
+        ++hitCount;
+    } else {
+        ++missCount;
+        plan = DSPPlan::compile(sdrConfig, options);
+        if (!store(path, *plan)) {
+            ++writeFailureCount;
+        }
+    }
+    plans.emplace(key, plan);
+    return plan;
+}
+
+std::shared_ptr<const DSPPlan> DSPPlanCache::load(const std::string& path,
+                                                  uint64_t key) const {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+    auto mapping = std::make_shared<MappedFile>(address, size);
+    return DSPPlan::fromImage(mapping, static_cast<const uint8_t*>(address),
+                              size, key, true);
+}
+
+bool DSPPlanCache::store(const std::string& path, const DSPPlan& plan) const {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        return false;
+    }
+    // Читатель видит либо старый файл, либо полностью записанный новый.
+    std::string tmpPath = path + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0) {
+        return false;
+    }
+    std::span<const uint8_t> image = plan.image();
+    size_t written = 0;
+    while (written < image.size()) {
+        ssize_t n = ::write(fd, image.data() + written, image.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    bool ok = written == image.size();
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || ::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace dsp
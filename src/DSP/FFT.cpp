@@ -0,0 +1,150 @@
+#include "FFT.hpp"
+
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+namespace dsp {
+
+namespace {
+
+void checkSize(size_t n) {
+    if (n < 2 || (n & (n - 1)) != 0) {
+        throw std::invalid_argument("FFT size must be a power of two: " +
+                                    std::to_string(n));
+    }
+}
+
+struct FFTTables {
+    std::vector<std::complex<float>> twiddles;
+    std::vector<uint32_t> bitReverse;
+};
+
+}  // namespace
+
+FFTPlan::FFTPlan(size_t size) : n(size) {
+    checkSize(n);
+    auto tables = std::make_shared<FFTTables>();
+    size_t bits = 0;
+    while ((size_t(1) << bits) < n) {
+        ++bits;
+    }
+    tables->bitReverse.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        tables->bitReverse[i] = static_cast<uint32_t>(r);
+    }
+    tables->twiddles.resize(n / 2);
+    for (size_t k = 0; k < n / 2; ++k) {
+        double phase = -2.0 * std::numbers::pi * static_cast<double>(k) /
+                       static_cast<double>(n);
+        tables->twiddles[k] = {static_cast<float>(std::cos(phase)),
+                               static_cast<float>(std::sin(phase))};
+    }
+    twiddles = tables->twiddles.data();
+    bitReverse = tables->bitReverse.data();
+    storage = std::move(tables);
+}
+
+FFTPlan::FFTPlan(size_t size, const std::complex<float>* twiddles,
+                 const uint32_t* bitReverse,
+                 std::shared_ptr<const void> storage)
+    : n(size),
+      storage(std::move(storage)),
+      twiddles(twiddles),
+      bitReverse(bitReverse) {
+    checkSize(n);
+    if (twiddles == nullptr || bitReverse == nullptr) {
+        throw std::invalid_argument("FFT plan tables are missing");
+    }
+}
+
+void FFTPlan::execute(std::complex<float>* data) const {
+    for (size_t i = 0; i < n; ++i) {
+        size_t j = bitReverse[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        size_t step = n / len;
+        for (size_t start = 0; start < n; start += len) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<float> t =
+                    twiddles[k * step] * data[start + k + half];
+                data[start + k + half] = data[start + k] - t;
+                data[start + k] += t;
+            }
+        }
+    }
+}
+
+namespace {
+
+std::mutex planCacheMutex;
+std::map<size_t, std::shared_ptr<const FFTPlan>> planCache;
+
+}  // namespace
+
+std::shared_ptr<const FFTPlan> FFTPlan::get(size_t size) {
+    std::lock_guard<std::mutex> lock(planCacheMutex);
+    auto it = planCache.find(size);
+    if (it != planCache.end()) {
+        return it->second;
+    }
+    auto plan = std::make_shared<const FFTPlan>(size);
+    planCache.emplace(size, plan);
+    return plan;
+}
+
+std::shared_ptr<const FFTPlan> FFTPlan::preload(
+    std::shared_ptr<const FFTPlan> plan) {
+    std::lock_guard<std::mutex> lock(planCacheMutex);
+    return planCache.try_emplace(plan->size(), plan).first->second;
+}
+
+std::shared_ptr<const std::vector<float>> getWindow(WindowType type,
+                                                    size_t size) {
+    static std::mutex cacheMutex;
+    static std::map<std::pair<WindowType, size_t>,
+                    std::shared_ptr<const std::vector<float>>>
+        cache;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto key = std::make_pair(type, size);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    auto window = std::make_shared<std::vector<float>>(size, 1.0f);
+    double denom = size > 1 ? static_cast<double>(size - 1) : 1.0;
+    for (size_t i = 0; i < size; ++i) {
+        double x = 2.0 * std::numbers::pi * static_cast<double>(i) / denom;
+        double w = 1.0;
+        switch (type) {
+            case WindowType::Rectangular:
+                w = 1.0;
+                break;
+            case WindowType::Hann:
+                w = 0.5 - 0.5 * std::cos(x);
+                break;
+            case WindowType::Hamming:
+                w = 0.54 - 0.46 * std::cos(x);
+                break;
+            case WindowType::Blackman:
+                w = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+                break;
+        }
+        (*window)[i] = static_cast<float>(w);
+    }
+    cache.emplace(key, window);
+    return window;
+}
+
+}  // namespace dsp
@@ -0,0 +1,87 @@
+#include "FIRFilter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace dsp {
+
+FIRFilter::FIRFilter(std::vector<float> taps)
+    : coefficients(std::move(taps)) {
+    if (coefficients.empty()) {
+        throw std::invalid_argument("FIR filter requires at least one tap");
+    }
+    std::reverse(coefficients.begin(), coefficients.end());
+    reset();
+}
+
+void FIRFilter::reset() { work.assign(coefficients.size() - 1, cf32{}); }
+
+void FIRFilter::process(cf32* data, size_t samples) {
+    size_t history = coefficients.size() - 1;
+    work.resize(history + samples);
+    std::copy_n(data, samples, work.begin() + static_cast<long>(history));
+
+    const float* h = coefficients.data();
+    const float* x = reinterpret_cast<const float*>(work.data());
+    float* y = reinterpret_cast<float*>(data);
+    size_t taps = coefficients.size();
+    for (size_t n = 0; n < samples; ++n) {
+        float re = 0.0f;
+        float im = 0.0f;
+        const float* xn = x + 2 * n;
+        for (size_t k = 0; k < taps; ++k) {
+            re += h[k] * xn[2 * k];
+            im += h[k] * xn[2 * k + 1];
+        }
+        y[2 * n] = re;
+        y[2 * n + 1] = im;
+    }
+
+    // Сохраняем хвост для следующего буфера.
+    std::copy(work.end() - static_cast<long>(history), work.end(),
+              work.begin());
+    work.resize(history);
+}
+
+std::vector<float> FIRFilter::movingAverage(size_t length) {
+    if (length == 0) {
+        throw std::invalid_argument("Moving average length must be positive");
+    }
+    return std::vector<float>(length, 1.0f / static_cast<float>(length));
+}
+
+std::vector<float> FIRFilter::lowPass(double cutoff, size_t length) {
+    if (length == 0) {
+        throw std::invalid_argument("Low-pass filter length must be positive");
+    }
+    if (cutoff <= 0.0 || cutoff > 0.5) {
+        throw std::invalid_argument(
+            "Low-pass cutoff must be in (0, 0.5] of the sample rate");
+    }
+    std::vector<double> h(length);
+    double center = static_cast<double>(length - 1) / 2.0;
+    double sum = 0.0;
+    for (size_t k = 0; k < length; ++k) {
+        double t = static_cast<double>(k) - center;
+        double sinc = t == 0.0 ? 2.0 * cutoff
+                               : std::sin(2.0 * std::numbers::pi * cutoff * t) /
+                                     (std::numbers::pi * t);
+        double window =
+            length == 1
+                ? 1.0
+                : 0.54 - 0.46 * std::cos(2.0 * std::numbers::pi *
+                                         static_cast<double>(k) /
+                                         static_cast<double>(length - 1));
+        h[k] = sinc * window;
+        sum += h[k];
+    }
+    std::vector<float> taps(length);
+    for (size_t k = 0; k < length; ++k) {
+        taps[k] = static_cast<float>(h[k] / sum);
+    }
+    return taps;
+}
+
+}  // namespace dsp
@@ -0,0 +1,83 @@
+#include "FrameSync.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace dsp {
+
+FrameSync::FrameSync(std::vector<cf32> syncSymbols, float threshold)
+    : reference(std::move(syncSymbols)),
+      referenceEnergy(0.0f),
+      threshold(threshold) {
+    if (reference.empty()) {
+        throw std::invalid_argument("Frame sync requires a sync sequence");
+    }
+    for (auto& s : reference) {
+        referenceEnergy += std::norm(s);
+        s = std::conj(s);
+    }
+    reset();
+}
+
+void FrameSync::reset() {
+    history.clear();
+    symbolsSeen = 0;
+    best = FrameSyncDetection{0, cf32{1.0f, 0.0f}, 0.0f};
+    hasCandidate = false;
+}
+
+size_t FrameSync::process(const cf32* symbols, size_t count,
+                          std::vector<FrameSyncDetection>& detections) {
+    constexpr float kQuarter = std::numbers::pi_v<float> / 2.0f;
+    size_t length = reference.size();
+    size_t found = 0;
+    uint64_t firstIndex = symbolsSeen - history.size();
+    history.insert(history.end(), symbols, symbols + count);
+
+    for (size_t w = 0; w + length <= history.size(); ++w) {
+        uint64_t index = firstIndex + w;
+        // Максимум корреляции ищется в окне длины кадра синхронизации.
+        if (hasCandidate && index >= best.symbolIndex + length) {
+            detections.push_back(best);
+            hasCandidate = false;
+            ++found;
+        }
+        cf32 corr{};
+        float energy = 0.0f;
+        const cf32* window = history.data() + w;
+        for (size_t k = 0; k < length; ++k) {
+            corr += reference[k] * window[k];
+            energy += std::norm(window[k]);
+        }
+        if (energy <= 0.0f) {
+            continue;
+        }
+        float metric = std::abs(corr) / std::sqrt(referenceEnergy * energy);
+        if (metric >= threshold && (!hasCandidate || metric > best.metric)) {
+            float quarters = std::round(std::arg(corr) / kQuarter);
+            best = FrameSyncDetection{index,
+                                      std::polar(1.0f, -quarters * kQuarter),
+                                      metric};
+            hasCandidate = true;
+        }
+    }
+
+    symbolsSeen += count;
+    size_t keep = std::min(history.size(), length - 1);
+    history.erase(history.begin(),
+                  history.end() - static_cast<long>(keep));
+    return found;
+}
+
+size_t FrameSync::flush(std::vector<FrameSyncDetection>& detections) {
+    if (!hasCandidate) {
+        return 0;
+    }
+    detections.push_back(best);
+    hasCandidate = false;
+    return 1;
+}
+
+}  // namespace dsp
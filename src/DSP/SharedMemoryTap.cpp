@@ -0,0 +1,138 @@
+#include "SharedMemoryTap.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace dsp {
+
+namespace {
+
+size_t roundUpPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+}  // namespace
+
+template <Sample T>
+SharedMemoryTap<T>::SharedMemoryTap(const std::string& name,
+                                    const SDRcfg::SDRConfig& sdrConfig,
+                                    size_t capacitySamples, bool unlinkOnClose)
+    : name(name),
+      capacitySamples(roundUpPowerOfTwo(std::max<size_t>(capacitySamples, 1))),
+      mappedSize(0),
+      unlinkOnClose(unlinkOnClose),
+      fd(-1),
+      mapping(nullptr),
+      header(nullptr),
+      data(nullptr) {
+    mappedSize = SHARED_RING_DATA_OFFSET + this->capacitySamples * sizeof(T) *
+                                               SampleTraits<T>::elementsPerSample;
+    fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open shared memory " + name +
+                                 ": " + std::strerror(errno));
+    }
+    if (::ftruncate(fd, static_cast<off_t>(mappedSize)) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to resize shared memory " + name +
+                                 ": " + std::strerror(err));
+    }
+    mapping = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fd, 0);
+    if (mapping == MAP_FAILED) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to map shared memory " + name + ": " +
+                                 std::strerror(err));
+    }
+
+    header = new (mapping) SharedRingHeader();
+    data = static_cast<uint8_t*>(mapping) + SHARED_RING_DATA_OFFSET;
+    header->version = SHARED_RING_VERSION;
+    header->dataOffset = SHARED_RING_DATA_OFFSET;
+    header->sampleFormat = static_cast<uint32_t>(
+        SampleTraits<T>::isFixedPoint ? SharedSampleFormat::Int16IQ
+                                      : SharedSampleFormat::Float32IQ);
+    header->bytesPerSample = static_cast<uint32_t>(
+        sizeof(T) * SampleTraits<T>::elementsPerSample);
+    header->capacity = this->capacitySamples;
+    header->sampleRate = sdrConfig.rxSampleRate;
+    header->frequency = sdrConfig.rxFrequency;
+    // Читатель проверяет magic, поэтому он пишется последним.
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHARED_RING_MAGIC;
+}
+
+template <Sample T>
+SharedMemoryTap<T>::~SharedMemoryTap() {
+    if (mapping != nullptr) {
+        ::munmap(mapping, mappedSize);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (unlinkOnClose) {
+        ::shm_unlink(name.c_str());
+    }
+}
+
+template <Sample T>
+void SharedMemoryTap<T>::push(const T* iq, size_t samples,
+                              uint64_t timestampNs) {
+    constexpr size_t elements = SampleTraits<T>::elementsPerSample;
+    constexpr size_t sampleBytes = sizeof(T) * elements;
+    uint64_t index = header->writeIndex.load(std::memory_order_relaxed);
+    // Больше ёмкости кольца хранить бессмысленно — пишется только хвост.
+    if (samples > capacitySamples) {
+        iq += (samples - capacitySamples) * elements;
+        index += samples - capacitySamples;
+        samples = capacitySamples;
+    }
+    // Резервирование публикуется до копирования: читатель, перечитавший
+    // writeBegin после своей копии, видит и незавершённую запись.
+    header->writeBegin.store(index + samples, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    size_t pos = static_cast<size_t>(index) & (capacitySamples - 1);
+    size_t first = std::min(samples, capacitySamples - pos);
+    std::memcpy(data + pos * sampleBytes, iq, first * sampleBytes);
+    if (first < samples) {
+        std::memcpy(data, iq + first * elements,
+                    (samples - first) * sampleBytes);
+    }
+    header->timestampNs.store(timestampNs, std::memory_order_relaxed);
+    header->writeIndex.store(index + samples, std::memory_order_release);
+}
+
+template <Sample T>
+void SharedMemoryTap<T>::process(T* iq, size_t samples) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    push(iq, samples,
+         static_cast<uint64_t>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(now)
+                 .count()));
+}
+
+template <Sample T>
+uint64_t SharedMemoryTap<T>::written() const {
+    return header->writeIndex.load(std::memory_order_relaxed);
+}
+
+template class SharedMemoryTap<int16_t>;
+template class SharedMemoryTap<float>;
+template class SharedMemoryTap<cf32>;
+
+}  // namespace dsp
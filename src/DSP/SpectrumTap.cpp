@@ -0,0 +1,182 @@
+#include "SpectrumTap.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace dsp {
+
+SpectrumSink::SpectrumSink(SpectrumSinkType type, const std::string& path)
+    : type(type), path(path), socketFd(-1) {
+    if (type == SpectrumSinkType::File) {
+        file.open(path, std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open spectrum sink file: " +
+                                     path);
+        }
+    } else if (type == SpectrumSinkType::UnixSocket) {
+        if (path.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::invalid_argument("Spectrum socket path is too long: " +
+                                        path);
+        }
+        socketFd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        if (socketFd < 0) {
+            throw std::runtime_error("Failed to create spectrum socket: " +
+                                     std::string(std::strerror(errno)));
+        }
+    }
+}
+
+SpectrumSink::~SpectrumSink() {
+    if (socketFd >= 0) {
+        ::close(socketFd);
+    }
+}
+
+bool SpectrumSink::write(const void* data, size_t size) {
+    switch (type) {
+        case SpectrumSinkType::None:
+            return true;
+        case SpectrumSinkType::File:
+            file.write(static_cast<const char*>(data),
+                       static_cast<std::streamsize>(size));
+            file.flush();
+            return file.good();
+        case SpectrumSinkType::UnixSocket: {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            // Нет читателя или переполнен буфер сокета — кадр теряется.
+            return ::sendto(socketFd, data, size, 0,
+                            reinterpret_cast<const sockaddr*>(&addr),
+                            sizeof(addr)) == static_cast<ssize_t>(size);
+        }
+    }
+    return false;
+}
+
+SpectrumTap::SpectrumTap(const SDRcfg::SDRConfig& sdrConfig,
+                         const SpectrumTapConfig& cfg)
+    : cfg(cfg),
+      centerFrequency(sdrConfig.rxFrequency),
+      sampleRate(sdrConfig.rxSampleRate),
+      bufferCounter(0),
+      segmentsAccumulated(0),
+      frameTimestampNs(0),
+      sequence(0) {
+    if (cfg.averages == 0 || cfg.decimation == 0) {
+        throw std::invalid_argument(
+            "Spectrum tap averages and decimation must be greater than 0");
+    }
+    if (cfg.overlap < 0.0 || cfg.overlap >= 1.0) {
+        throw std::invalid_argument("Spectrum tap overlap must be in [0, 1)");
+    }
+    // Сегменты не переходят через границу буфера: между принятыми
+    // буферами прореживание выбрасывает данные, и склеенный сегмент
+    // содержал бы разрыв.
+    if (sdrConfig.bufferSize < cfg.fftSize) {
+        throw std::invalid_argument(
+            "Spectrum tap FFT size " + std::to_string(cfg.fftSize) +
+            " exceeds buffer size " + std::to_string(sdrConfig.bufferSize));
+    }
+    plan = FFTPlan::get(cfg.fftSize);
+    window = getWindow(cfg.window, cfg.fftSize);
+    hop = std::max<size_t>(
+        1, static_cast<size_t>(static_cast<double>(cfg.fftSize) *
+                               (1.0 - cfg.overlap)));
+
+    // Нормировка к спектральной плотности мощности: 1 / (fs * sum(w^2)).
+    double windowPower = 0.0;
+    for (float w : *window) {
+        windowPower += static_cast<double>(w) * w;
+    }
+    double fs = sampleRate > 0.0 ? sampleRate : 1.0;
+    scale = static_cast<float>(
+        1.0 / (fs * windowPower * static_cast<double>(cfg.averages)));
+
+    segment.resize(cfg.fftSize);
+    accum.assign(cfg.fftSize, 0.0f);
+    frameDb.assign(cfg.fftSize, 0.0f);
+    frameBuffer.resize(sizeof(SpectrumFrameHeader) +
+                       cfg.fftSize * sizeof(float));
+    sink = std::make_unique<SpectrumSink>(cfg.sinkType, cfg.sinkPath);
+}
+
+uint64_t SpectrumTap::segmentOffsetNs(size_t offset) const {
+    if (sampleRate <= 0.0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(
+        std::llround(static_cast<double>(offset) * 1e9 / sampleRate));
+}
+
+template <Sample T>
+void SpectrumTap::push(const T* iq, size_t samples, uint64_t timestampNs) {
+    // Прореживание по времени: лишние буферы отбрасываются без обработки.
+    if (bufferCounter++ % cfg.decimation != 0) {
+        return;
+    }
+    using Traits = SampleTraits<T>;
+    const auto* src = scalars(iq);
+    const float* w = window->data();
+    for (size_t offset = 0; offset + cfg.fftSize <= samples; offset += hop) {
+        if (segmentsAccumulated == 0) {
+            frameTimestampNs = timestampNs + segmentOffsetNs(offset);
+        }
+        const auto* seg = src + 2 * offset;
+        for (size_t i = 0; i < cfg.fftSize; ++i) {
+            segment[i] = {Traits::toFloat(seg[2 * i]) * w[i],
+                          Traits::toFloat(seg[2 * i + 1]) * w[i]};
+        }
+        plan->execute(segment.data());
+        for (size_t i = 0; i < cfg.fftSize; ++i) {
+            accum[i] += std::norm(segment[i]);
+        }
+        if (++segmentsAccumulated == cfg.averages) {
+            publish();
+            // Остаток буфера не нужен: следующий кадр начнётся с
+            // очередного принятого буфера.
+            break;
+        }
+    }
+}
+
+template void SpectrumTap::push<int16_t>(const int16_t*, size_t, uint64_t);
+template void SpectrumTap::push<float>(const float*, size_t, uint64_t);
+template void SpectrumTap::push<cf32>(const cf32*, size_t, uint64_t);
+
+void SpectrumTap::publish() {
+    size_t n = cfg.fftSize;
+    size_t half = n / 2;
+    for (size_t i = 0; i < n; ++i) {
+        // fftshift: отрицательные частоты в начало кадра.
+        float power = accum[(i + half) % n] * scale;
+        frameDb[i] = 10.0f * std::log10(std::max(power, 1e-20f));
+    }
+    std::fill(accum.begin(), accum.end(), 0.0f);
+    segmentsAccumulated = 0;
+
+    SpectrumFrameHeader header{};
+    header.magic = SPECTRUM_FRAME_MAGIC;
+    header.version = SPECTRUM_FRAME_VERSION;
+    header.headerSize = sizeof(SpectrumFrameHeader);
+    header.bins = static_cast<uint32_t>(n);
+    header.averages = static_cast<uint32_t>(cfg.averages);
+    header.sequence = sequence++;
+    header.timestampNs = frameTimestampNs;
+    header.centerFrequency = centerFrequency;
+    header.sampleRate = sampleRate;
+    std::memcpy(frameBuffer.data(), &header, sizeof(header));
+    std::memcpy(frameBuffer.data() + sizeof(header), frameDb.data(),
+                n * sizeof(float));
+    sink->write(frameBuffer.data(), frameBuffer.size());
+}
+
+}  // namespace dsp
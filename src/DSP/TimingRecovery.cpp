@@ -0,0 +1,65 @@
+#include "TimingRecovery.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dsp {
+
+GardnerTimingRecovery::GardnerTimingRecovery(const TimingRecoveryConfig& cfg)
+    : sps(cfg.samplesPerSymbol) {
+    if (sps < 2) {
+        throw std::invalid_argument(
+            "Timing recovery requires at least 2 samples per symbol");
+    }
+    float zeta = cfg.damping;
+    float theta = (cfg.loopBandwidth / static_cast<float>(sps)) /
+                  (zeta + 0.25f / zeta);
+    float denominator =
+        (1.0f + 2.0f * zeta * theta + theta * theta) * cfg.detectorGain;
+    k1 = -4.0f * zeta * theta / denominator;
+    k2 = -4.0f * theta * theta / denominator;
+    reset();
+}
+
+void GardnerTimingRecovery::reset() {
+    integrator = 0.0f;
+    tau = 0;
+    nextIndex = 0;
+    buffer.clear();
+}
+
+size_t GardnerTimingRecovery::process(const cf32* samples, size_t count,
+                                      std::vector<cf32>& symbols) {
+    buffer.insert(buffer.end(), samples, samples + count);
+    size_t produced = 0;
+    int n = static_cast<int>(sps);
+    // Смещение tau лежит в [-sps, sps], поэтому для символа нужно
+    // 2 * sps отсчётов впереди.
+    while (nextIndex + 2 * sps < buffer.size()) {
+        int start = static_cast<int>(nextIndex) + tau;
+        if (start >= 0) {
+            const cf32& first = buffer[static_cast<size_t>(start)];
+            const cf32& mid = buffer[static_cast<size_t>(start + n / 2)];
+            const cf32& last = buffer[static_cast<size_t>(start + n)];
+            float err = (last.real() - first.real()) * mid.real() +
+                        (last.imag() - first.imag()) * mid.imag();
+            integrator = std::clamp(integrator + err * k1 + err * k2, -1.0f,
+                                    1.0f);
+            tau = static_cast<int>(
+                std::lround(integrator * static_cast<float>(sps)));
+            // Как в main.py: символ берётся уже с обновлённым tau.
+            int sample = std::max(static_cast<int>(nextIndex) + tau, 0);
+            symbols.push_back(buffer[static_cast<size_t>(sample)]);
+            ++produced;
+        }
+        nextIndex += sps;
+    }
+    // Оставляем sps отсчётов перед следующим символом на случай tau < 0.
+    size_t drop = nextIndex > sps ? nextIndex - sps : 0;
+    buffer.erase(buffer.begin(), buffer.begin() + static_cast<long>(drop));
+    nextIndex -= drop;
+    return produced;
+}
+
+}  // namespace dsp
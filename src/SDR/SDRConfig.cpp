@@ -11,8 +11,12 @@ SDRcfg::SDRConfig::SDRConfig()
       txSampleRate(0.0),
       txBandwidth(0.0),
       gain(0.0),
+      gainMode(GainMode::Manual),
       bufferSize(0),
-      multiplier(1) {}
+      multiplier(1),
+      dataSourceType(DataSourceType::UnknowSource),
+      dataSourcePath(""),
+      repeatCount(0) {}
 
 SDRcfg::SDRConfig::SDRConfig(SDRDeviceType type, const std::string& name,
                              const std::string& address, double rxFreq,
@@ -49,5 +53,9 @@ SDRcfg::SDRConfig::SDRConfig(const SDRConfig& other)
       txSampleRate(other.txSampleRate),
       txBandwidth(other.txBandwidth),
       gain(other.gain),
+      gainMode(other.gainMode),
       bufferSize(other.bufferSize),
-      multiplier(other.multiplier) {}
\ No newline at end of file
+      multiplier(other.multiplier),
+      dataSourceType(other.dataSourceType),
+      dataSourcePath(other.dataSourcePath),
+      repeatCount(other.repeatCount) {}
\ No newline at end of file
@@ -4,11 +4,13 @@
 
 SDR::SDR(const SDRcfg::SDRConfig& cfg) : config(cfg) { allocateBuffers(); }
 
+void SDR::setGain(double gainDb) { config.gain = gainDb; }
+
 void SDR::allocateBuffers() {
     size_t totalSize = config.bufferSize * 2;  // I и Q
     try {
-        rxBuffer = std::make_unique<int16_t[]>(totalSize);
-        txBuffer = std::make_unique<int16_t[]>(totalSize);
+        rxBuffer = std::make_unique<SampleType[]>(totalSize);
+        txBuffer = std::make_unique<SampleType[]>(totalSize);
     } catch (const std::bad_alloc& e) {
         throw std::runtime_error("Failed to allocate buffers: " +
                                  std::string(e.what()));
@@ -18,3 +18,8 @@ void SoapySDRDriver::sendSamples() {
 void SoapySDRDriver::receiveSamples() {
     std::cout << "Receiving samples from SoapySDR" << std::endl;
 }
+
+void SoapySDRDriver::setGain(double gainDb) {
+    SDR::setGain(gainDb);
+    std::cout << "Setting SoapySDR gain: " << gainDb << " dB." << std::endl;
+}
@@ -9,6 +9,7 @@ class SoapySDRDriver : public SDR {
     void initialize() override;
     void sendSamples() override;
     void receiveSamples() override;
+    void setGain(double gainDb) override;
 };
 
 #endif
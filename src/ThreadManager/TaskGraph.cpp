@@ -0,0 +1,95 @@
+#include "ThreadManager.hpp"
+
+TaskGraph::TaskGraph() : data(std::make_shared<Data>()) {}
+
+TaskGraph::Data& TaskGraph::mutableData() {
+    if (data.use_count() > 1) {
+        data = std::make_shared<Data>(*data);
+    }
+    return *data;
+}
+
+TaskGraph::NodeID TaskGraph::addNode(Task task,
+                                     const std::vector<NodeID>& predecessors,
+                                     TaskPriority priority) {
+    Data& d = mutableData();
+    NodeID id = d.nodes.size();
+    d.nodes.push_back(Node{std::move(task), priority, {}, 0});
+    for (NodeID before : predecessors) {
+        precede(before, id);
+    }
+    return id;
+}
+
+void TaskGraph::precede(NodeID before, NodeID after) {
+    Data& d = mutableData();
+    // Ребро только от ранее добавленного узла к более позднему, поэтому
+    // цикл построить нельзя.
+    if (before >= after || after >= d.nodes.size()) {
+        ERROR("Invalid graph edge: " << before << " -> " << after);
+        return;
+    }
+    d.nodes[before].successors.push_back(after);
+    d.nodes[after].predecessors++;
+}
+
+void TaskGraph::onComplete(Task callback) {
+    mutableData().completionCallbacks.push_back(std::move(callback));
+}
+
+size_t TaskGraph::size() const { return data->nodes.size(); }
+
+GraphRun::GraphRun(std::shared_ptr<const TaskGraph::Data> graph,
+                   size_t groupID, uint64_t epoch,
+                   std::function<void()> continuation)
+    : graph(std::move(graph)),
+      groupID(groupID),
+      epoch(epoch),
+      continuation(std::move(continuation)),
+      pending(std::make_unique<std::atomic<size_t>[]>(
+          this->graph->nodes.size())),
+      remaining(this->graph->nodes.size()),
+      failed(false),
+      cancelled(false),
+      finished(false) {
+    for (size_t i = 0; i < this->graph->nodes.size(); ++i) {
+        pending[i].store(this->graph->nodes[i].predecessors);
+    }
+}
+
+void GraphRun::finish() {
+    for (const auto& callback : graph->completionCallbacks) {
+        try {
+            callback();
+        } catch (const std::exception& e) {
+            ERROR("Graph completion callback error: " << e.what());
+        }
+    }
+    if (continuation) {
+        try {
+            continuation();
+        } catch (const std::exception& e) {
+            ERROR("Graph continuation error: " << e.what());
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    cv.notify_all();
+    LOG("Graph run completed");
+}
+
+bool GraphRun::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return finished; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return !cancelled.load();
+}
+
+bool GraphRun::done() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return finished;
+}
@@ -1,87 +1,226 @@
 #include "ThreadManager.hpp"
 
-ThreadManager::ThreadManager(size_t maxThreads, bool roundRobin)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+// Последние микросекунды до срока таймера досыпаются активным ожиданием:
+// пробуждение по timerfd запаздывает на время планирования потока. Запас
+// мал, чтобы не занимать ядро: точность timerfd обеспечивает нулевой
+// timer slack потока таймеров (см. timerThreadLoop()).
+constexpr uint64_t kTimerSpinUs = 5;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+}  // namespace
+
+ThreadManager::ThreadManager(size_t maxThreads, bool roundRobin,
+                             size_t minThreads,
+                             std::chrono::milliseconds idleTimeout)
     : running(true),
       tasksInQueue(0),
       activeThreads(0),
       busyWorkers(0),
       nextTaskID(1),
       groupRunning(std::bitset<MAX_THREAD_GROUP>().set()),
-      maxThreads(maxThreads),
-      roundRobin(roundRobin) {
+      maxThreads(std::max<size_t>(maxThreads, 1)),
+      roundRobin(roundRobin),
+      minThreads(minThreads),
+      idleTimeout(idleTimeout),
+      pendingRetirements(0),
+      timerWheel(toTimerTick(Clock::now())),
+      nextTimerID(1),
+      timerNextTick(UINT64_MAX),
+      timerRunning(false),
+      timerStopping(false),
+      timerFd(-1),
+      timerWakeFd(-1) {
     LOG("ThreadManager started with max " << maxThreads << " threads");
 }
 
-ThreadManager::ThreadManager() { stopAll(); }
+ThreadManager::~ThreadManager() { stopAll(); }
 
 void ThreadManager::stopAll() {
+    stopTimerThread();
+    std::vector<std::thread> toJoin;
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        std::unique_lock<std::mutex> lock(queueMutex);
         running.store(false);
         cv.notify_all();  // Уведомляем всех потоков о завершении
+        // Выполняющиеся задачи (например, узлы графа) ещё могут ставить
+        // задачи в очередь; новые потоки после running == false не
+        // создаются, поэтому после их завершения список потоков полон.
+        doneCv.wait(lock, [this] { return busyWorkers.load() == 0; });
+        for (auto& [id, thread] : threads) {
+            toJoin.push_back(std::move(thread));
+        }
+        threads.clear();
+        for (auto& thread : finishedThreads) {
+            toJoin.push_back(std::move(thread));
+        }
+        finishedThreads.clear();
     }
-    for (auto& thread : threads) {
+    for (auto& thread : toJoin) {
         if (thread.joinable()) {
             thread.join();
         }
     }
-    threads.clear();
     LOG("ThreadManager stopped");
 }
 
-void ThreadManager::stopGroup(size_t groupID) {
-    if (groupID >= MAX_THREAD_GROUP) {
-        ERROR("Invalid group ID: " << groupID);
-        return;
-    }
+thread_local CancellationToken ThreadManager::currentTaskToken;
+
+void ThreadManager::setGroupRunning(size_t groupID, bool value) {
     std::bitset<MAX_THREAD_GROUP> expected = groupRunning.load();
     std::bitset<MAX_THREAD_GROUP> desired = expected;
-    desired.reset(groupID);  // Сбрасываем нужный бит
+    desired.set(groupID, value);
     while (!groupRunning.compare_exchange_weak(expected, desired)) {
         desired = expected;
-        desired.reset(groupID);
+        desired.set(groupID, value);
     }
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        std::priority_queue<TaskEntry, std::vector<TaskEntry>,
-                            std::greater<TaskEntry>>
-            newQueue;
-        while (!taskQueue.empty()) {
-            auto taskEntry = taskQueue.top();
-            taskQueue.pop();
-            if (taskEntry.groupID != groupID) {
-                newQueue.push(taskEntry);
-            }
-        }
-        taskQueue = std::move(newQueue);
+}
+
+void ThreadManager::stopGroup(size_t groupID) {
+    if (groupID >= MAX_THREAD_GROUP) {
+        ERROR("Invalid group ID: " << groupID);
+        return;
     }
+    setGroupRunning(groupID, false);  // Сбрасываем нужный бит
+    cancelGroup(groupID);
     LOG("Group " << groupID << " stopped");
 }
 
+void ThreadManager::cancelGroup(size_t groupID) {
+    if (groupID >= MAX_THREAD_GROUP) {
+        ERROR("Invalid group ID: " << groupID);
+        return;
+    }
+    // Новая эпоха делает устаревшими все задачи группы в очереди и токены
+    // выполняющихся задач; сама очередь не трогается.
+    groupEpoch[groupID].fetch_add(1, std::memory_order_acq_rel);
+    LOG("Group " << groupID << " cancelled");
+}
+
+void ThreadManager::resumeGroup(size_t groupID) {
+    if (groupID >= MAX_THREAD_GROUP) {
+        ERROR("Invalid group ID: " << groupID);
+        return;
+    }
+    // Задачи, добавленные в остановленную группу, остаются снятыми.
+    groupEpoch[groupID].fetch_add(1, std::memory_order_acq_rel);
+    setGroupRunning(groupID, true);
+    LOG("Group " << groupID << " resumed");
+}
+
+CancellationToken ThreadManager::cancellationToken(size_t groupID) const {
+    if (groupID >= MAX_THREAD_GROUP) {
+        ERROR("Invalid group ID: " << groupID);
+        return CancellationToken();
+    }
+    return CancellationToken(&groupEpoch[groupID],
+                             groupEpoch[groupID].load());
+}
+
+CancellationToken ThreadManager::currentToken() { return currentTaskToken; }
+
+void ThreadManager::waitForGroup(size_t groupID) {
+    if (groupID >= MAX_THREAD_GROUP) {
+        ERROR("Invalid group ID: " << groupID);
+        return;
+    }
+    std::unique_lock<std::mutex> lock(queueMutex);
+    doneCv.wait(lock, [this, groupID] { return groupPending[groupID] == 0; });
+    LOG("waitForGroup " << groupID << " completed");
+}
+
+bool ThreadManager::isStale(const TaskEntry& entry) const {
+    return !groupRunning.load()[entry.groupID] ||
+           entry.epoch != groupEpoch[entry.groupID].load();
+}
+
+void ThreadManager::finishTask(size_t groupID) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    busyWorkers--;
+    groupPending[groupID]--;
+    if (groupPending[groupID] == 0 || busyWorkers.load() == 0) {
+        doneCv.notify_all();  // Группа, все задачи или все потоки свободны
+        LOG("Tasks completed");
+    }
+}
+
 void ThreadManager::resizeThreadPool(size_t newSize) {
-    if (newSize < maxThreads) {
-        size_t threadsToStop = maxThreads - newSize;
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            running.store(false);
-            cv.notify_all();  // Уведомляем всех потоков о завершении
-        }
-        for (size_t i = 0; i < threadsToStop; ++i) {
-            if (threads.back().joinable()) {
-                threads.back().join();
-            }
-            threads.pop_back();
-        }
-        maxThreads = newSize;
-    } else {
+    if (newSize == 0) {
+        ERROR("Thread pool size must be greater than 0");
+        return;
+    }
+    {
+        // Лишние потоки сами завершаются между задачами (shouldRetire),
+        // остальные продолжают работу: глобальной остановки нет.
+        std::lock_guard<std::mutex> lock(queueMutex);
         maxThreads = newSize;
+        cv.notify_all();
+    }
+    startWorkerIfNecessary();
+    LOG("Thread pool resized to " << newSize << " threads");
+}
+
+void ThreadManager::retireWorkers(size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pendingRetirements =
+            std::min(pendingRetirements + count, activeThreads.load());
+        cv.notify_all();
+    }
+    joinFinishedThreads();
+}
+
+bool ThreadManager::shouldRetire(bool idleTimedOut) const {
+    size_t active = activeThreads.load();
+    if (active > maxThreads) {
+        return true;
+    }
+    if (pendingRetirements > 0 && (taskQueue.empty() || active > 1)) {
+        return true;
+    }
+    return idleTimedOut && taskQueue.empty() && active > minThreads;
+}
+
+void ThreadManager::retireCurrentWorker() {
+    // Вызывается под queueMutex. Собственный std::thread переносится в
+    // finishedThreads, join выполнит следующий вызов joinFinishedThreads.
+    activeThreads--;
+    if (pendingRetirements > 0) {
+        pendingRetirements--;
+    }
+    auto it = threads.find(std::this_thread::get_id());
+    if (it != threads.end()) {
+        finishedThreads.push_back(std::move(it->second));
+        threads.erase(it);
     }
+    LOG("Worker thread retired, active_threads: " << activeThreads.load());
+}
+
+void ThreadManager::joinFinishedThreads() {
+    std::vector<std::thread> toJoin;
     {
         std::lock_guard<std::mutex> lock(queueMutex);
-        running.store(true);
-        cv.notify_all();  // Уведомляем новые потоки о начале работы
+        toJoin.swap(finishedThreads);
+    }
+    for (auto& thread : toJoin) {
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
-    LOG("Thread pool resized to " << maxThreads << " threads");
 }
 
 void ThreadManager::workerThread() {
@@ -89,14 +228,23 @@ void ThreadManager::workerThread() {
         TaskEntry taskEntry;
         {
             std::unique_lock<std::mutex> lock(queueMutex);
-            cv.wait(lock,
-                    [this] { return !taskQueue.empty() || !running.load(); });
+            bool woken = cv.wait_for(lock, idleTimeout, [this] {
+                return !taskQueue.empty() || !running.load() ||
+                       shouldRetire(false);
+            });
             if (!running.load() && taskQueue.empty()) {
                 LOG("Worker thread exiting");
-                activeThreads--;
+                retireCurrentWorker();
                 return;  // Завершаем работу, если нет задач и флаг running
                          // установлен в false
             }
+            if (shouldRetire(!woken)) {
+                retireCurrentWorker();
+                return;
+            }
+            if (taskQueue.empty()) {
+                continue;
+            }
             taskEntry = taskQueue.top();
             taskQueue.pop();
             tasksInQueue--;
@@ -105,38 +253,39 @@ void ThreadManager::workerThread() {
                 << tasksInQueue.load()
                 << ", busy_workers: " << busyWorkers.load());
         }
-        if (!groupRunning.load()[taskEntry.groupID]) {
+        if (isStale(taskEntry)) {
             LOG("Skipping task from group " << taskEntry.groupID);
-            {
-                std::lock_guard<std::mutex> lock(queueMutex);
-                busyWorkers--;
+            if (taskEntry.onCancel) {
+                taskEntry.onCancel();
             }
+            finishTask(taskEntry.groupID);
             continue;  // Пропускаем задачи из остановленных групп
         }
+        currentTaskToken = CancellationToken(&groupEpoch[taskEntry.groupID],
+                                             taskEntry.epoch);
         try {
             (*taskEntry.task)();
         } catch (const std::exception& e) {
             ERROR("Task error: " << e.what());
         }
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            busyWorkers--;
-            if (busyWorkers.load() + tasksInQueue.load() == 0) {
-                cv.notify_one();  // Все задачи выполнены
-                LOG("All tasks completed");
-            }
-        }
+        currentTaskToken = CancellationToken();
+        finishTask(taskEntry.groupID);
     }
 }
 
 std::unordered_map<size_t, size_t> ThreadManager::waitForAll() {
     std::unique_lock<std::mutex> lock(queueMutex);
-    cv.wait(lock,
-            [this] { return (busyWorkers.load() + tasksInQueue.load()) == 0; });
+    doneCv.wait(lock, [this] {
+        return (busyWorkers.load() + tasksInQueue.load()) == 0;
+    });
     LOG("waitForAll completed");
     std::unordered_map<size_t, size_t> results;
     for (auto& [taskID, future] : taskResults) {
-        results[taskID] = future.get();
+        try {
+            results[taskID] = future.get();
+        } catch (const std::future_error&) {
+            // Задача снята с выполнения отменой группы
+        }
     }
     taskResults.clear();
     return results;
@@ -161,13 +310,360 @@ size_t ThreadManager::waitForTask(size_t taskID) {
     return future.get();
 }
 
+void ThreadManager::enqueue(TaskEntry entry) {
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (!running.load()) {
+            // После stopAll() задачи не принимаются: освобождённые узлы
+            // графа проходят по пути отмены, чтобы запуск завершился.
+            lock.unlock();
+            LOG("ThreadManager is stopped, task rejected");
+            if (entry.onCancel) {
+                entry.onCancel();
+            }
+            return;
+        }
+        groupPending[entry.groupID]++;
+        taskQueue.push(std::move(entry));
+        tasksInQueue++;
+    }
+    cv.notify_one();
+    startWorkerIfNecessary();
+}
+
+std::shared_ptr<GraphRun> ThreadManager::runGraph(
+    const TaskGraph& graph, size_t groupID,
+    std::function<void()> continuation) {
+    if (groupID >= MAX_THREAD_GROUP) {
+        ERROR("Invalid group ID: " << groupID);
+        return nullptr;
+    }
+    std::shared_ptr<GraphRun> run(new GraphRun(graph.data, groupID,
+                                               groupEpoch[groupID].load(),
+                                               std::move(continuation)));
+    const auto& nodes = run->graph->nodes;
+    if (nodes.empty()) {
+        run->finish();
+        return run;
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].predecessors == 0) {
+            enqueueGraphNode(run, i);
+        }
+    }
+    LOG("Graph started with " << nodes.size() << " nodes, Group ID: "
+                              << groupID);
+    return run;
+}
+
+void ThreadManager::enqueueGraphNode(const std::shared_ptr<GraphRun>& run,
+                                     size_t node) {
+    auto packagedTask = std::make_shared<std::packaged_task<size_t()>>(
+        [this, run, node]() -> size_t {
+            executeGraphNode(run, node, false);
+            return 0;
+        });
+    // Узлы наследуют эпоху запуска: отмена группы снимает и узлы,
+    // освободившиеся после неё.
+    enqueue(TaskEntry{packagedTask, run->graph->nodes[node].priority,
+                      run->groupID, run->epoch, nextTaskID++,
+                      [this, run, node] { executeGraphNode(run, node, true); }});
+}
+
+void ThreadManager::executeGraphNode(const std::shared_ptr<GraphRun>& run,
+                                     size_t node, bool cancelled) {
+    const auto& graphNode = run->graph->nodes[node];
+    if (cancelled) {
+        run->cancelled.store(true);
+    } else if (!run->failed.load() && !run->cancelled.load()) {
+        try {
+            graphNode.task();
+        } catch (...) {
+            bool expected = false;
+            if (run->failed.compare_exchange_strong(expected, true)) {
+                run->error = std::current_exception();
+            }
+            ERROR("Graph node " << node << " failed");
+        }
+    }
+    // Преемники освобождаются здесь же, без возврата к вызывающему.
+    // После отмены или ошибки они только проходят по графу, не выполняясь.
+    for (size_t successor : graphNode.successors) {
+        if (run->pending[successor].fetch_sub(1) == 1) {
+            enqueueGraphNode(run, successor);
+        }
+    }
+    if (run->remaining.fetch_sub(1) == 1) {
+        run->finish();
+    }
+}
+
 void ThreadManager::startWorkerIfNecessary() {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    if (activeThreads.load() < maxThreads && tasksInQueue.load() > 0) {
-        threads.emplace_back(&ThreadManager::workerThread, this);
-        activeThreads++;
-        LOG("Started new worker thread, active_threads: "
-            << activeThreads.load());
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!running.load()) {
+            return;  // stopAll() уже собирает потоки для join
+        }
+        // Рост пропорционален очереди: по потоку на задачу, которую не
+        // могут взять свободные потоки, в пределах maxThreads.
+        size_t active = activeThreads.load();
+        size_t busy = std::min(busyWorkers.load(), active);
+        size_t idle = active - busy;
+        size_t backlog = tasksInQueue.load();
+        size_t wanted = backlog > idle ? backlog - idle : 0;
+        // Потоки, ожидающие завершения, выгоднее оставить в работе.
+        size_t kept = std::min(pendingRetirements, wanted);
+        pendingRetirements -= kept;
+        wanted -= kept;
+        size_t room = maxThreads > active ? maxThreads - active : 0;
+        for (size_t i = 0; i < std::min(wanted, room); ++i) {
+            std::thread thread(&ThreadManager::workerThread, this);
+            std::thread::id id = thread.get_id();
+            threads.emplace(id, std::move(thread));
+            activeThreads++;
+            LOG("Started new worker thread, active_threads: "
+                << activeThreads.load());
+        }
+    }
+    joinFinishedThreads();
+}
+
+uint64_t ThreadManager::toTimerTick(Clock::time_point time) {
+    // steady_clock в Linux — CLOCK_MONOTONIC, тот же, что у timerfd.
+    // Округление вверх: задача не запускается раньше срока.
+    return static_cast<uint64_t>(
+        std::chrono::ceil<std::chrono::microseconds>(time.time_since_epoch())
+            .count());
+}
+
+ThreadManager::TimerID ThreadManager::scheduleAt(Clock::time_point when,
+                                                 Task task,
+                                                 TaskPriority priority,
+                                                 size_t groupID) {
+    return addTimer(toTimerTick(when), 0, std::move(task), priority,
+                    groupID);
+}
+
+ThreadManager::TimerID ThreadManager::scheduleAfter(
+    std::chrono::microseconds delay, Task task, TaskPriority priority,
+    size_t groupID) {
+    return scheduleAt(Clock::now() + delay, std::move(task), priority,
+                      groupID);
+}
+
+ThreadManager::TimerID ThreadManager::scheduleEvery(
+    std::chrono::microseconds period, Task task, TaskPriority priority,
+    size_t groupID) {
+    if (period.count() <= 0) {
+        ERROR("Timer period must be positive");
+        return 0;
+    }
+    uint64_t periodUs = static_cast<uint64_t>(period.count());
+    return addTimer(toTimerTick(Clock::now()) + periodUs, periodUs,
+                    std::move(task), priority, groupID);
+}
+
+ThreadManager::TimerID ThreadManager::addTimer(uint64_t expiry,
+                                               uint64_t period, Task task,
+                                               TaskPriority priority,
+                                               size_t groupID) {
+    if (groupID >= MAX_THREAD_GROUP) {
+        ERROR("Invalid group ID: " << groupID);
+        return 0;
+    }
+    if (!task) {
+        ERROR("Timer task is empty");
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(timerMutex);
+    if (!running.load() || timerStopping) {
+        ERROR("ThreadManager is stopped, timer rejected");
+        return 0;
+    }
+    if (!startTimerThread()) {
+        return 0;
+    }
+    TimerID timerID = nextTimerID++;
+    timers.emplace(timerID,
+                   TimerEntry{std::make_shared<Task>(std::move(task)), expiry,
+                              period, priority, groupID,
+                              groupEpoch[groupID].load()});
+    timerWheel.insert(timerID, expiry);
+    if (expiry < timerNextTick) {
+        // Поток таймеров спит до более позднего срока — будим.
+        uint64_t one = 1;
+        if (write(timerWakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            ERROR("Timer wakeup failed: " << std::strerror(errno));
+        }
+    }
+    LOG("Timer " << timerID << " scheduled at " << expiry << " us");
+    return timerID;
+}
+
+bool ThreadManager::cancelTimer(TimerID timerID) {
+    // Запись в колесе остаётся до срока и там пропускается.
+    std::lock_guard<std::mutex> lock(timerMutex);
+    return timers.erase(timerID) > 0;
+}
+
+bool ThreadManager::startTimerThread() {
+    // Вызывается под timerMutex.
+    if (timerRunning) {
+        return true;
+    }
+    if (timerThread.joinable()) {
+        // Поток таймеров останавливается и ещё не присоединён.
+        ERROR("Timer thread is stopping, timer rejected");
+        return false;
+    }
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    timerWakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (timerFd < 0 || timerWakeFd < 0) {
+        ERROR("Failed to create timer descriptors: " << std::strerror(errno));
+        if (timerFd >= 0) {
+            close(timerFd);
+        }
+        if (timerWakeFd >= 0) {
+            close(timerWakeFd);
+        }
+        timerFd = timerWakeFd = -1;
+        return false;
+    }
+    timerRunning = true;
+    timerThread = std::thread(&ThreadManager::timerThreadLoop, this);
+    LOG("Timer thread started");
+    return true;
+}
+
+void ThreadManager::stopTimerThread() {
+    {
+        // timerStopping выставляется до остановки потока: задачи пула,
+        // вызывающие scheduleAfter() во время stopAll(), не должны
+        // перезапустить поток, который ещё не присоединён.
+        std::lock_guard<std::mutex> lock(timerMutex);
+        timerStopping = true;
+        if (!timerRunning) {
+            return;
+        }
+        timerRunning = false;
+        uint64_t one = 1;
+        if (write(timerWakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            ERROR("Timer wakeup failed: " << std::strerror(errno));
+        }
+    }
+    if (timerThread.joinable()) {
+        timerThread.join();
+    }
+    std::lock_guard<std::mutex> lock(timerMutex);
+    close(timerFd);
+    close(timerWakeFd);
+    timerFd = timerWakeFd = -1;
+    timers.clear();
+    timerWheel = TimerWheel(toTimerTick(Clock::now()));
+    timerNextTick = UINT64_MAX;
+    LOG("Timer thread stopped");
+}
+
+void ThreadManager::timerThreadLoop() {
+    // По умолчанию ядро откладывает пробуждение до 50 мкс (timer slack),
+    // что перекрыло бы запас активного ожидания.
+    if (prctl(PR_SET_TIMERSLACK, 1UL) < 0) {
+        ERROR("prctl(PR_SET_TIMERSLACK) failed: " << std::strerror(errno));
+    }
+    std::vector<TimerID> expired;
+    std::vector<TaskEntry> due;
+    while (true) {
+        std::optional<uint64_t> nextTick;
+        bool nextIsExpiry = false;
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            if (!timerRunning) {
+                return;
+            }
+            uint64_t now = toTimerTick(Clock::now());
+            expired.clear();
+            timerWheel.advance(now, expired);
+            for (TimerID timerID : expired) {
+                auto it = timers.find(timerID);
+                if (it == timers.end()) {
+                    continue;  // Таймер отменён
+                }
+                TimerEntry& timer = it->second;
+                if (timer.epoch != groupEpoch[timer.groupID].load()) {
+                    timers.erase(it);  // Группа отменена
+                    continue;
+                }
+                auto packagedTask =
+                    std::make_shared<std::packaged_task<size_t()>>(
+                        [task = timer.task]() -> size_t {
+                            try {
+                                (*task)();
+                            } catch (const std::exception& e) {
+                                ERROR("Timer task error: " << e.what());
+                            }
+                            return 0;
+                        });
+                due.push_back(TaskEntry{packagedTask, timer.priority,
+                                        timer.groupID, timer.epoch,
+                                        nextTaskID++, nullptr});
+                if (timer.period == 0) {
+                    timers.erase(it);
+                    continue;
+                }
+                timer.expiry += timer.period;
+                if (timer.expiry <= now) {
+                    // Пропущенные периоды (например, при перегрузке)
+                    // не наверстываются пачкой.
+                    uint64_t missed = (now - timer.expiry) / timer.period + 1;
+                    timer.expiry += missed * timer.period;
+                    LOG("Timer " << timerID << " skipped " << missed
+                                 << " periods");
+                }
+                timerWheel.insert(timerID, timer.expiry);
+            }
+            nextTick = timerWheel.nextTick();
+            nextIsExpiry = timerWheel.nextTickIsExpiry();
+            timerNextTick = nextTick.value_or(UINT64_MAX);
+        }
+        for (auto& entry : due) {
+            enqueue(std::move(entry));
+        }
+        due.clear();
+        waitForTimer(nextTick, nextIsExpiry);
+    }
+}
+
+void ThreadManager::waitForTimer(std::optional<uint64_t> tick, bool expiry) {
+    uint64_t now = toTimerTick(Clock::now());
+    uint64_t spin = expiry ? kTimerSpinUs : 0;
+    if (!tick || *tick > now + spin) {
+        itimerspec spec{};
+        if (tick) {
+            uint64_t armAt = *tick - spin;
+            spec.it_value.tv_sec = static_cast<time_t>(armAt / 1000000);
+            spec.it_value.tv_nsec = static_cast<long>(armAt % 1000000) * 1000;
+        }
+        // Нулевое значение снимает таймер: ждём только пробуждения.
+        if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+            ERROR("timerfd_settime failed: " << std::strerror(errno));
+        }
+        pollfd fds[2] = {{timerFd, POLLIN, 0}, {timerWakeFd, POLLIN, 0}};
+        while (poll(fds, 2, -1) < 0 && errno == EINTR) {
+        }
+        uint64_t counter;
+        if (fds[0].revents & POLLIN) {
+            (void)!read(timerFd, &counter, sizeof(counter));
+        }
+        if (fds[1].revents & POLLIN) {
+            (void)!read(timerWakeFd, &counter, sizeof(counter));
+            return;  // Новый таймер или остановка: пересчитать срок
+        }
+    }
+    if (!expiry) {
+        return;
+    }
+    while (toTimerTick(Clock::now()) < *tick) {
+        cpuRelax();
     }
 }
 
@@ -0,0 +1,173 @@
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+#include <bit>
+
+TimerWheel::TimerWheel(uint64_t startTick) : current(startTick), count(0) {}
+
+void TimerWheel::mark(Level& level, size_t slot) {
+    level.occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+void TimerWheel::unmark(Level& level, size_t slot) {
+    level.occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+}
+
+std::optional<size_t> TimerWheel::findOccupied(const Level& level,
+                                               size_t from) {
+    for (size_t word = from / 64; word < level.occupied.size(); ++word) {
+        uint64_t bits = level.occupied[word];
+        if (word == from / 64) {
+            bits &= ~uint64_t(0) << (from % 64);
+        }
+        if (bits != 0) {
+            return word * 64 + static_cast<size_t>(std::countr_zero(bits));
+        }
+    }
+    return std::nullopt;
+}
+
+void TimerWheel::insert(TimerID id, uint64_t expiryTick) {
+    place(Entry{id, expiryTick});
+    ++count;
+}
+
+void TimerWheel::place(const Entry& entry) {
+    if (entry.expiry < current) {
+        // Такт уже пройден: слот current сработал бы только на такте
+        // current, то есть позже ближайшего advance() с тем же nowTick.
+        overdue.push_back(entry);
+        return;
+    }
+    uint64_t expiry = entry.expiry;
+    uint64_t delta = expiry - current;
+    size_t level = 0;
+    while (level < kLevels &&
+           delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    if (level == kLevels) {
+        // Дальше охвата колеса: ставим в самый дальний слот верхнего
+        // уровня, при перекладке срок будет пересчитан.
+        level = kLevels - 1;
+        expiry = current + (uint64_t(1) << (kSlotBits * kLevels)) - 1;
+    }
+    size_t slot = (expiry >> (kSlotBits * level)) & kSlotMask;
+    levels[level].slots[slot].push_back(entry);
+    mark(levels[level], slot);
+}
+
+void TimerWheel::cascade() {
+    // Сверху вниз: таймеры старшего уровня могут попасть в слот младшего,
+    // который перекладывается на этом же шаге.
+    for (size_t level = kLevels - 1; level > 0; --level) {
+        uint64_t span = uint64_t(1) << (kSlotBits * level);
+        if (current % span != 0) {
+            continue;
+        }
+        size_t slot = (current >> (kSlotBits * level)) & kSlotMask;
+        std::vector<Entry> entries;
+        entries.swap(levels[level].slots[slot]);
+        unmark(levels[level], slot);
+        for (const Entry& entry : entries) {
+            place(entry);
+        }
+    }
+}
+
+void TimerWheel::fireCurrent(std::vector<TimerID>& expired) {
+    size_t slot = current & kSlotMask;
+    if (levels[0].slots[slot].empty()) {
+        return;
+    }
+    std::vector<Entry> entries;
+    entries.swap(levels[0].slots[slot]);
+    unmark(levels[0], slot);
+    for (const Entry& entry : entries) {
+        if (entry.expiry <= current) {
+            expired.push_back(entry.id);
+            --count;
+        } else {
+            place(entry);
+        }
+    }
+}
+
+void TimerWheel::advance(uint64_t nowTick, std::vector<TimerID>& expired) {
+    for (const Entry& entry : overdue) {
+        expired.push_back(entry.id);
+    }
+    count -= overdue.size();
+    overdue.clear();
+    while (current <= nowTick) {
+        if ((current & kSlotMask) == 0) {
+            cascade();
+        }
+        fireCurrent(expired);
+        // Пустые такты и границы с пустыми слотами пропускаются целиком.
+        auto event = nextEvent(current + 1);
+        current = event ? std::min(event->tick, nowTick + 1) : nowTick + 1;
+    }
+}
+
+std::optional<TimerWheel::Event> TimerWheel::nextEvent(uint64_t from) const {
+    if (count == 0) {
+        return std::nullopt;
+    }
+    size_t slot = from & kSlotMask;
+    uint64_t base = from - slot;
+    std::optional<Event> best;
+    if (auto next = findOccupied(levels[0], slot)) {
+        best = Event{base + *next, true};
+        if (slot != 0) {
+            return best;  // Раньше следующей границы ничего не бывает
+        }
+    } else if (auto wrapped = findOccupied(levels[0], 0)) {
+        best = Event{base + kSlots + *wrapped, true};
+    }
+    for (size_t level = 1; level < kLevels; ++level) {
+        size_t shift = kSlotBits * level;
+        uint64_t block = from >> shift;
+        size_t index = block & kSlotMask;
+        bool aligned = from % (uint64_t(1) << shift) == 0;
+        std::optional<size_t> next;
+        if (aligned) {
+            // Слот этого блока ещё не переложен.
+            next = findOccupied(levels[level], index);
+        } else if (index + 1 < kSlots) {
+            next = findOccupied(levels[level], index + 1);
+        }
+        uint64_t blocksAhead = 0;
+        if (next) {
+            blocksAhead = *next - index;
+        } else if (auto wrapped = findOccupied(levels[level], 0)) {
+            blocksAhead = kSlots - index + *wrapped;
+        } else {
+            continue;
+        }
+        uint64_t tick = (block + blocksAhead) << shift;
+        if (!best || tick < best->tick) {
+            best = Event{tick, false};
+        }
+    }
+    return best;
+}
+
+std::optional<uint64_t> TimerWheel::nextTick() const {
+    if (!overdue.empty()) {
+        return current - 1;  // Уже наступил
+    }
+    auto event = nextEvent(current);
+    if (!event) {
+        return std::nullopt;
+    }
+    return event->tick;
+}
+
+bool TimerWheel::nextTickIsExpiry() const {
+    if (!overdue.empty()) {
+        return true;
+    }
+    auto event = nextEvent(current);
+    return event && event->expiry;
+}
@@ -0,0 +1,529 @@
+// Прогон записанного сигнала через полную цепочку приёма
+// ([шумоподавитель] -> фильтр -> символьная синхронизация -> петля Костаса
+// -> поиск кадра)
+// с выводом результатов в JSON. См. src/bench/README.md.
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BurstDetector.hpp"
+#include "CarrierRecovery.hpp"
+#include "FIRFilter.hpp"
+#include "FrameSync.hpp"
+#include "SampleTypes.hpp"
+#include "TimingRecovery.hpp"
+
+namespace {
+
+using dsp::cf32;
+using Clock = std::chrono::steady_clock;
+
+// Отображение пар бит в символы QPSK из python_examples/generate.
+enum class Mapping { Gray, Natural };
+
+struct Options {
+    std::string capture;
+    std::string output;
+    size_t bufferSize = 1024;
+    size_t repeat = 200;
+    bool realtime = false;
+    bool gate = false;
+    double sampleRate = 1e6;
+    size_t samplesPerSymbol = 10;
+    size_t syncLength = 16;
+    float syncThreshold = 0.8f;
+    bool hasPayload = false;
+    std::string payloadText;
+    std::string syncBits;
+    Mapping mapping = Mapping::Gray;
+};
+
+// Известное содержимое эталонных записей из data/.
+void applyCaptureProfile(Options& opt) {
+    std::string name = std::filesystem::path(opt.capture).filename();
+    if (name == "qpsk_signal.bin") {
+        // generate/main2.py: Баркер-13 + текст, натуральное отображение.
+        opt.hasPayload = true;
+        opt.payloadText = "This is a text ? Yes !!";
+        opt.syncBits = "1111100110101";
+        opt.mapping = Mapping::Natural;
+    } else if (name == "qpsk_signal_noise.bin" ||
+               name == "qpsk_signal_no_phase.bin") {
+        // generate/main3.py: только текст, код Грея, шум канала.
+        opt.hasPayload = true;
+        opt.payloadText = "This is a text ? Yes !";
+        opt.syncBits.clear();
+        opt.mapping = Mapping::Gray;
+    }
+}
+
+void printUsage() {
+    std::cerr
+        << "Usage: TRXReplayBench <capture.bin|.pcm> [options]\n"
+           "  --buffer N          samples per buffer (default 1024)\n"
+           "  --repeat N          capture repetitions (default 200)\n"
+           "  --realtime          pace buffers at --rate\n"
+           "  --rate HZ           sample rate for pacing (default 1e6)\n"
+           "  --gate              pass only detected bursts to the chain\n"
+           "  --sps N             samples per symbol (default 10)\n"
+           "  --payload TEXT      known payload text\n"
+           "  --sync-bits BITS    sync word bits preceding the payload\n"
+           "  --mapping gray|natural\n"
+           "  --no-payload        skip BER measurement\n"
+           "  --sync-length N     symbols used for frame sync (default 16)\n"
+           "  --output FILE       write JSON to FILE instead of stdout\n";
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options opt;
+    std::vector<std::string> args(argv + 1, argv + argc);
+    for (const auto& a : args) {
+        if (!a.starts_with("--")) {
+            opt.capture = a;
+            break;
+        }
+    }
+    if (opt.capture.empty()) {
+        throw std::invalid_argument("Capture file is not specified");
+    }
+    applyCaptureProfile(opt);
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& a = args[i];
+        auto value = [&]() -> const std::string& {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument("Missing value for " + a);
+            }
+            return args[++i];
+        };
+        if (a == "--buffer") {
+            opt.bufferSize = std::stoul(value());
+        } else if (a == "--repeat") {
+            opt.repeat = std::stoul(value());
+        } else if (a == "--realtime") {
+            opt.realtime = true;
+        } else if (a == "--gate") {
+            opt.gate = true;
+        } else if (a == "--rate") {
+            opt.sampleRate = std::stod(value());
+        } else if (a == "--sps") {
+            opt.samplesPerSymbol = std::stoul(value());
+        } else if (a == "--payload") {
+            opt.payloadText = value();
+            opt.hasPayload = true;
+        } else if (a == "--sync-bits") {
+            opt.syncBits = value();
+        } else if (a == "--mapping") {
+            const std::string& m = value();
+            if (m == "gray") {
+                opt.mapping = Mapping::Gray;
+            } else if (m == "natural") {
+                opt.mapping = Mapping::Natural;
+            } else {
+                throw std::invalid_argument("Unknown mapping: " + m);
+            }
+        } else if (a == "--no-payload") {
+            opt.hasPayload = false;
+        } else if (a == "--sync-length") {
+            opt.syncLength = std::stoul(value());
+        } else if (a == "--output") {
+            opt.output = value();
+        } else if (a.starts_with("--")) {
+            throw std::invalid_argument("Unknown option: " + a);
+        }
+    }
+    if (opt.bufferSize == 0 || opt.repeat == 0 || opt.sampleRate <= 0.0) {
+        throw std::invalid_argument(
+            "Buffer size, repeat count and rate must be positive");
+    }
+    return opt;
+}
+
+std::vector<uint8_t> packetBits(const Options& opt) {
+    std::vector<uint8_t> bits;
+    for (char c : opt.syncBits) {
+        if (c != '0' && c != '1') {
+            throw std::invalid_argument("Invalid sync bits: " + opt.syncBits);
+        }
+        bits.push_back(static_cast<uint8_t>(c - '0'));
+    }
+    for (unsigned char c : opt.payloadText) {
+        for (int b = 7; b >= 0; --b) {
+            bits.push_back(static_cast<uint8_t>((c >> b) & 1));
+        }
+    }
+    if (bits.size() % 2 != 0) {
+        bits.push_back(0);
+    }
+    return bits;
+}
+
+const cf32* constellation(Mapping mapping) {
+    // Индекс — пара бит (b0 << 1) | b1.
+    static const cf32 gray[4] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+    static const cf32 natural[4] = {{1, 1}, {-1, 1}, {-1, -1}, {1, -1}};
+    return mapping == Mapping::Gray ? gray : natural;
+}
+
+size_t demap(cf32 symbol, const cf32* points) {
+    size_t bestIndex = 0;
+    float bestDistance = std::norm(symbol - points[0]);
+    for (size_t i = 1; i < 4; ++i) {
+        float d = std::norm(symbol - points[i]);
+        if (d < bestDistance) {
+            bestDistance = d;
+            bestIndex = i;
+        }
+    }
+    return bestIndex;
+}
+
+std::vector<int16_t> loadCapture(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Failed to open capture file: " + path);
+    }
+    auto size = static_cast<size_t>(ifs.tellg());
+    // I/Q int16, лишний хвост неполного отсчёта отбрасывается.
+    std::vector<int16_t> data(size / (2 * sizeof(int16_t)) * 2);
+    ifs.seekg(0);
+    ifs.read(reinterpret_cast<char*>(data.data()),
+             static_cast<std::streamsize>(data.size() * sizeof(int16_t)));
+    if (data.empty()) {
+        throw std::runtime_error("Capture file is empty: " + path);
+    }
+    return data;
+}
+
+uint64_t threadCpuNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull +
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+enum Stage { Gate, Convert, Filter, Timing, Carrier, Sync, StageCount };
+const char* const kStageNames[StageCount] = {
+    "gate", "convert", "filter", "timing", "carrier", "sync"};
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    auto index = static_cast<size_t>(
+        std::lround(q * static_cast<double>(sorted.size() - 1)));
+    return sorted[index];
+}
+
+// Строка в кавычках по правилам JSON (путь к записи может содержать
+// кавычки, обратные косые черты и управляющие символы).
+std::string jsonString(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+                                  static_cast<unsigned>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        opt = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    try {
+        std::vector<int16_t> capture = loadCapture(opt.capture);
+        size_t captureSamples = capture.size() / 2;
+
+        // Нормировка по максимуму, как в python_examples/receive.
+        int peak = 1;
+        for (int16_t v : capture) {
+            peak = std::max(peak, std::abs(static_cast<int>(v)));
+        }
+        float scale = 1.0f / static_cast<float>(peak);
+
+        std::vector<uint8_t> bits;
+        std::vector<cf32> packet;
+        const cf32* points = constellation(opt.mapping);
+        if (opt.hasPayload) {
+            bits = packetBits(opt);
+            for (size_t i = 0; i < bits.size(); i += 2) {
+                packet.push_back(points[(bits[i] << 1) | bits[i + 1]]);
+            }
+        }
+
+        dsp::FIRFilter filter(
+            dsp::FIRFilter::movingAverage(opt.samplesPerSymbol));
+        dsp::TimingRecoveryConfig timingCfg;
+        timingCfg.samplesPerSymbol = opt.samplesPerSymbol;
+        dsp::GardnerTimingRecovery timing(timingCfg);
+        dsp::CostasLoop carrier;
+        std::vector<cf32> syncRef(
+            packet.begin(),
+            packet.begin() + static_cast<long>(
+                                 std::min(opt.syncLength, packet.size())));
+        std::unique_ptr<dsp::FrameSync> sync;
+        if (!syncRef.empty()) {
+            sync = std::make_unique<dsp::FrameSync>(syncRef,
+                                                    opt.syncThreshold);
+        }
+
+        std::vector<cf32> samples(opt.bufferSize);
+        std::vector<cf32> symbols;
+        std::vector<cf32> allSymbols;
+        std::vector<dsp::FrameSyncDetection> detections;
+        std::vector<double> latenciesUs;
+        uint64_t stageNs[StageCount] = {};
+        uint64_t totalSamples = 0;
+        uint64_t totalSymbols = 0;
+        uint64_t chainNs = 0;
+
+        // Дорогая часть цепочки для одного отрезка отсчётов.
+        auto processSamples = [&](const int16_t* src, size_t n) {
+            uint64_t t0 = threadCpuNs();
+            for (size_t i = 0; i < n; ++i) {
+                samples[i] = {static_cast<float>(src[2 * i]) * scale,
+                              static_cast<float>(src[2 * i + 1]) * scale};
+            }
+            uint64_t t1 = threadCpuNs();
+            filter.process(samples.data(), n);
+            uint64_t t2 = threadCpuNs();
+            symbols.clear();
+            timing.process(samples.data(), n, symbols);
+            uint64_t t3 = threadCpuNs();
+            carrier.process(symbols.data(), symbols.size());
+            uint64_t t4 = threadCpuNs();
+            if (sync) {
+                sync->process(symbols.data(), symbols.size(), detections);
+            }
+            uint64_t t5 = threadCpuNs();
+
+            stageNs[Convert] += t1 - t0;
+            stageNs[Filter] += t2 - t1;
+            stageNs[Timing] += t3 - t2;
+            stageNs[Carrier] += t4 - t3;
+            stageNs[Sync] += t5 - t4;
+            chainNs += t5 - t0;
+            totalSymbols += symbols.size();
+            if (sync) {
+                allSymbols.insert(allSymbols.end(), symbols.begin(),
+                                  symbols.end());
+            }
+        };
+
+        // Шумоподавитель перед цепочкой: отрезок с предысторией может быть
+        // длиннее буфера, поэтому он обрабатывается частями.
+        std::unique_ptr<dsp::BurstDetector<int16_t>> gate;
+        if (opt.gate) {
+            gate = std::make_unique<dsp::BurstDetector<int16_t>>(
+                opt.sampleRate,
+                [&](const int16_t* iq, size_t n,
+                    const dsp::BurstSegment& segment) {
+                    if (segment.begin) {
+                        // Новый пакет: захват заново.
+                        filter.reset();
+                        timing.reset();
+                        carrier.reset();
+                    }
+                    for (size_t done = 0; done < n; done += opt.bufferSize) {
+                        processSamples(iq + 2 * done,
+                                       std::min(opt.bufferSize, n - done));
+                    }
+                });
+        }
+
+        auto start = Clock::now();
+        for (size_t rep = 0; rep < opt.repeat; ++rep) {
+            for (size_t offset = 0; offset < captureSamples;
+                 offset += opt.bufferSize) {
+                size_t n = std::min(opt.bufferSize, captureSamples - offset);
+                Clock::time_point arrival;
+                if (opt.realtime) {
+                    // Буфер "приходит", когда в эфире набралось n отсчётов.
+                    arrival = start +
+                              std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double>(
+                                      static_cast<double>(totalSamples + n) /
+                                      opt.sampleRate));
+                    std::this_thread::sleep_until(arrival);
+                } else {
+                    arrival = Clock::now();
+                }
+
+                const int16_t* src = capture.data() + 2 * offset;
+                if (gate) {
+                    uint64_t chainBefore = chainNs;
+                    uint64_t t0 = threadCpuNs();
+                    gate->push(src, n,
+                               static_cast<int64_t>(
+                                   static_cast<double>(totalSamples) * 1e9 /
+                                   opt.sampleRate));
+                    stageNs[Gate] +=
+                        threadCpuNs() - t0 - (chainNs - chainBefore);
+                } else {
+                    processSamples(src, n);
+                }
+                latenciesUs.push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() -
+                                                              arrival)
+                        .count());
+                totalSamples += n;
+            }
+        }
+        if (gate) {
+            gate->flush();
+        }
+        double wallSeconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+        if (sync) {
+            sync->flush(detections);
+        }
+
+        // Сравнение с известным пакетом для каждого найденного кадра.
+        uint64_t framesDecoded = 0;
+        uint64_t bitErrors = 0;
+        uint64_t symbolErrors = 0;
+        for (const auto& d : detections) {
+            if (d.symbolIndex + packet.size() > allSymbols.size()) {
+                continue;
+            }
+            ++framesDecoded;
+            for (size_t k = 0; k < packet.size(); ++k) {
+                cf32 s = allSymbols[d.symbolIndex + k] * d.rotation;
+                size_t got = demap(s, points);
+                size_t expected = (static_cast<size_t>(bits[2 * k]) << 1) |
+                                  bits[2 * k + 1];
+                size_t diff = got ^ expected;
+                symbolErrors += diff != 0;
+                bitErrors += (diff & 1) + (diff >> 1);
+            }
+        }
+        uint64_t bitsCompared = framesDecoded * bits.size();
+        uint64_t symbolsCompared = framesDecoded * packet.size();
+
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        double totalCpuNs = 0.0;
+        for (uint64_t ns : stageNs) {
+            totalCpuNs += static_cast<double>(ns);
+        }
+        double msps = static_cast<double>(totalSamples) / wallSeconds / 1e6;
+
+        std::ostringstream json;
+        json.precision(6);
+        json << "{\n";
+        json << "  \"capture\": " << jsonString(opt.capture) << ",\n";
+        json << "  \"mode\": \"" << (opt.realtime ? "realtime" : "max")
+             << "\",\n";
+        json << "  \"buffer_size\": " << opt.bufferSize << ",\n";
+        json << "  \"repeat\": " << opt.repeat << ",\n";
+        json << "  \"samples\": " << totalSamples << ",\n";
+        json << "  \"wall_time_s\": " << wallSeconds << ",\n";
+        json << "  \"msps\": " << msps << ",\n";
+        json << "  \"cpu_time_s\": " << totalCpuNs / 1e9 << ",\n";
+        json << "  \"stages\": {\n";
+        for (size_t s = 0; s < StageCount; ++s) {
+            double ns = static_cast<double>(stageNs[s]);
+            json << "    \"" << kStageNames[s] << "\": {\"cpu_time_s\": "
+                 << ns / 1e9 << ", \"ns_per_sample\": "
+                 << ns / static_cast<double>(totalSamples)
+                 << ", \"share\": " << (totalCpuNs > 0 ? ns / totalCpuNs : 0)
+                 << "}" << (s + 1 < StageCount ? "," : "") << "\n";
+        }
+        json << "  },\n";
+        json << "  \"latency_us\": {\"p50\": " << percentile(latenciesUs, 0.5)
+             << ", \"p90\": " << percentile(latenciesUs, 0.9)
+             << ", \"p99\": " << percentile(latenciesUs, 0.99)
+             << ", \"max\": " << percentile(latenciesUs, 1.0) << "},\n";
+        if (gate) {
+            json << "  \"gate\": {\"bursts\": " << gate->bursts()
+                 << ", \"forwarded_samples\": " << gate->samplesForwarded()
+                 << ", \"forwarded_share\": "
+                 << static_cast<double>(gate->samplesForwarded()) /
+                        static_cast<double>(totalSamples)
+                 << ", \"noise_floor_db\": " << gate->noiseFloorDb()
+                 << "},\n";
+        }
+        json << "  \"symbols\": " << totalSymbols << ",\n";
+        if (opt.hasPayload) {
+            json << "  \"frames_expected\": " << opt.repeat << ",\n";
+            json << "  \"frames_detected\": " << detections.size() << ",\n";
+            json << "  \"frames_decoded\": " << framesDecoded << ",\n";
+            json << "  \"bits_compared\": " << bitsCompared << ",\n";
+            json << "  \"bit_errors\": " << bitErrors << ",\n";
+            json << "  \"ber\": "
+                 << (bitsCompared ? static_cast<double>(bitErrors) /
+                                        static_cast<double>(bitsCompared)
+                                  : 1.0)
+                 << ",\n";
+            json << "  \"ser\": "
+                 << (symbolsCompared ? static_cast<double>(symbolErrors) /
+                                           static_cast<double>(symbolsCompared)
+                                     : 1.0)
+                 << "\n";
+        } else {
+            json << "  \"ber\": null\n";
+        }
+        json << "}\n";
+
+        if (opt.output.empty()) {
+            std::cout << json.str();
+        } else {
+            std::ofstream ofs(opt.output);
+            if (!ofs.is_open()) {
+                throw std::runtime_error("Failed to open output file: " +
+                                         opt.output);
+            }
+            ofs << json.str();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
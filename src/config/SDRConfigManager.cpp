@@ -1,38 +1,63 @@
 #include "SDRConfigManager.hpp"
 
-#include <regex>
+#include <charconv>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 #include "SDRDriver.hpp"
 
+// Значение вида "<число>[пробелы]<единица>", например "2.4 GHz" или
+// "1MSPS". Разбор вручную: std::regex на каждое поле заметно дороже
+// всего остального чтения конфигурации.
 static double parseValueWithMultiplier(const std::string& value) {
-    static const std::regex regex(R"((\d+(\.\d+)?)\s*([kMG]?Hz|[kM]?SPS))");
-    std::smatch match;
-
-    if (std::regex_match(value, match, regex)) {
-        double number = std::stod(match[1]);
-        std::string unit = match[3];
-
-        if (unit == "Hz" || unit.empty()) {
-            return number;
-        } else if (unit == "kHz" || unit == "k") {
-            return number * 1e3;
-        } else if (unit == "MHz" || unit == "M") {
-            return number * 1e6;
-        } else if (unit == "GHz" || unit == "G") {
-            return number * 1e9;
-        } else if (unit == "SPS") {
-            return number;
-        } else if (unit == "KSPS" || unit == "kSPS") {
-            return number * 1e3;
-        } else if (unit == "MSPS" || unit == "MS") {
-            return number * 1e6;
+    struct Unit {
+        std::string_view name;
+        double multiplier;
+    };
+    static constexpr Unit kUnits[] = {
+        {"Hz", 1.0},  {"kHz", 1e3},  {"MHz", 1e6}, {"GHz", 1e9},
+        {"SPS", 1.0}, {"kSPS", 1e3}, {"MSPS", 1e6},
+    };
+    auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+    auto isSpace = [](char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' ||
+               c == '\f' || c == '\r';
+    };
+
+    const char* begin = value.data();
+    const char* end = begin + value.size();
+    const char* p = begin;
+    while (p < end && isDigit(*p)) {
+        ++p;
+    }
+    if (p == begin) {
+        throw std::invalid_argument("Invalid value format: " + value);
+    }
+    if (p < end && *p == '.') {
+        const char* fraction = ++p;
+        while (p < end && isDigit(*p)) {
+            ++p;
+        }
+        if (p == fraction) {
+            throw std::invalid_argument("Invalid value format: " + value);
         }
-
-        throw std::invalid_argument("Unsupported unit: " + unit);
+    }
+    double number = 0.0;
+    auto [parsedEnd, ec] = std::from_chars(begin, p, number);
+    if (ec != std::errc() || parsedEnd != p) {
+        throw std::invalid_argument("Invalid value format: " + value);
+    }
+    while (p < end && isSpace(*p)) {
+        ++p;
     }
 
+    std::string_view unit(p, static_cast<size_t>(end - p));
+    for (const Unit& u : kUnits) {
+        if (unit == u.name) {
+            return number * u.multiplier;
+        }
+    }
     throw std::invalid_argument("Invalid value format: " + value);
 }
 
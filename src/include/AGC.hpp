@@ -0,0 +1,75 @@
+#ifndef AGC_HPP
+#define AGC_HPP
+
+#include <cstdint>
+#include <functional>
+
+#include "SDRConfig.hpp"
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+struct AGCConfig {
+    float targetLevel = 0.25f;  // Целевой СКЗ уровень (доля полной шкалы)
+    float minGainDb = -20.0f;   // Пределы программного усиления
+    float maxGainDb = 60.0f;
+
+    // Постоянные времени огибающей, с.
+    float slowAttackTime = 0.05f;
+    float slowDecayTime = 0.5f;
+    float fastAttackTime = 0.002f;
+    float fastDecayTime = 0.1f;
+
+    // Если программное усиление отклоняется больше чем на этот порог,
+    // целая часть переносится в аппаратное усиление драйвера.
+    float hardwareStepDb = 10.0f;
+    double hardwareMinGainDb = 0.0;
+    double hardwareMaxGainDb = 70.0;
+};
+
+// Программная АРУ для режимов SDRcfg::GainMode::SlowAttack / FastAttack.
+// Огибающая оценивается по мощности целого блока, а усиление плавно
+// интерполируется от предыдущего значения к новому в пределах блока.
+// В режиме Manual блок ничего не делает.
+template <Sample T>
+class AGC {
+   public:
+    using SampleType = T;
+    using HardwareGainCallback = std::function<void(double gainDb)>;
+
+    explicit AGC(const SDRcfg::SDRConfig& sdrConfig,
+                 const AGCConfig& cfg = AGCConfig());
+
+    void setHardwareGainCallback(HardwareGainCallback callback);
+
+    // Обработка на месте. `samples` — число комплексных отсчётов.
+    void process(T* iq, size_t samples);
+
+    float gainDb() const;
+    double hardwareGainDb() const { return hardwareGain; }
+    SDRcfg::GainMode mode() const { return gainMode; }
+
+   private:
+    float nextGain(float blockPower, size_t samples);
+
+    AGCConfig cfg;
+    SDRcfg::GainMode gainMode;
+    double sampleRate;
+    float attackTime;
+    float decayTime;
+    float minGain;
+    float maxGain;
+
+    float envelope;  // СКЗ входа
+    float gain;      // Текущее линейное усиление
+    double hardwareGain;
+    HardwareGainCallback hardwareGainCallback;
+};
+
+extern template class AGC<int16_t>;
+extern template class AGC<float>;
+extern template class AGC<cf32>;
+
+}  // namespace dsp
+
+#endif  // AGC_HPP
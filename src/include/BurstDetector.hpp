@@ -0,0 +1,121 @@
+#ifndef BURSTDETECTOR_HPP
+#define BURSTDETECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+struct BurstDetectorConfig {
+    size_t blockLength = 64;  // Отсчётов на одно решение
+    size_t windowBlocks = 4;  // Скользящее окно оценки мощности, блоков
+
+    // Пороги относительно уровня шума (гистерезис): пакет начинается при
+    // превышении onThresholdDb и заканчивается, когда мощность держится
+    // ниже offThresholdDb дольше postTrigger отсчётов.
+    float onThresholdDb = 10.0f;
+    float offThresholdDb = 6.0f;
+
+    size_t preTrigger = 256;   // Отсчётов до срабатывания
+    size_t postTrigger = 512;  // Отсчётов после спада
+
+    float noiseFloorTime = 0.5f;  // Постоянная времени уровня шума, с
+
+    // Пакет длиннее этого принудительно завершается, а уровень шума
+    // переоценивается по текущему окну: устойчивый рост шума больше
+    // onThresholdDb иначе держал бы шумоподавитель открытым. 0 — без
+    // ограничения.
+    float maxBurstTime = 1.0f;  // с
+};
+
+// Описание отрезка пакета, переданного обработчику.
+struct BurstSegment {
+    uint64_t burstIndex;   // Порядковый номер пакета
+    uint64_t firstSample;  // Абсолютный номер первого отсчёта отрезка
+    int64_t timestampNs;   // Время первого отсчёта отрезка
+    bool begin;            // Первый отрезок пакета (с предысторией)
+    bool end;              // Последний отрезок пакета
+    float snrDb;           // Мощность окна над уровнем шума
+};
+
+// Энергетический шумоподавитель перед дорогой частью цепочки приёма.
+// Мощность оценивается поблочно (векторизуемая сумма квадратов) в
+// скользящем окне, уровень шума отслеживается между пакетами. Дальше
+// передаются только отрезки пакетов: по одному вызову обработчика на
+// входной буфер, пока пакет длится, плюс предыстория при срабатывании.
+template <Sample T>
+class BurstDetector {
+   public:
+    using SegmentCallback = std::function<void(
+        const T* iq, size_t samples, const BurstSegment& segment)>;
+
+    BurstDetector(double sampleRate, SegmentCallback callback,
+                  const BurstDetectorConfig& cfg = BurstDetectorConfig());
+
+    // `timestampNs` — время первого отсчёта буфера.
+    void push(const T* iq, size_t samples, int64_t timestampNs);
+    // Завершает незакрытый пакет (конец потока, перестройка частоты).
+    void flush();
+    void reset();
+
+    bool inBurst() const { return active; }
+    float noiseFloorDb() const;
+    uint64_t bursts() const { return burstCount; }
+    uint64_t samplesProcessed() const { return totalSamples; }
+    uint64_t samplesForwarded() const { return forwardedSamples; }
+
+   private:
+    void completeBlock(const T* iq, uint64_t bufferStart, size_t end);
+    void emit(const T* iq, uint64_t bufferStart, uint64_t from, uint64_t to,
+              bool begin, bool end);
+    void saveHistory(const T* iq, size_t samples);
+    int64_t timestampOf(uint64_t sample) const;
+    float snrDb() const;
+
+    BurstDetectorConfig cfg;
+    double sampleRate;
+    SegmentCallback callback;
+    float onRatio;
+    float offRatio;
+    float floorAlpha;
+    uint64_t maxBurstSamples;  // 0 — без ограничения
+
+    // Окно мощностей последних блоков.
+    std::vector<float> blockPowers;
+    size_t blockCursor;
+    size_t blocksSeen;
+
+    // Текущий (неполный) блок.
+    float blockAccumulator;
+    size_t blockFill;
+
+    float noiseFloor;
+    bool active;
+    size_t hangover;        // Осталось отсчётов до конца пакета
+    uint64_t burstStart;    // Первый отсчёт текущего пакета
+    uint64_t emittedUntil;  // Конец последнего переданного отрезка
+    float lastSnr;  // Мощность окна / уровень шума в последнем блоке
+
+    // Последние preTrigger + blockLength отсчётов до текущего буфера.
+    std::vector<T> history;
+    size_t historySamples;
+    std::vector<T> scratch;
+
+    uint64_t totalSamples;
+    uint64_t forwardedSamples;
+    uint64_t burstCount;
+    uint64_t timestampSample;  // Отсчёт, к которому привязана метка
+    int64_t timestampBaseNs;
+};
+
+extern template class BurstDetector<int16_t>;
+extern template class BurstDetector<float>;
+extern template class BurstDetector<cf32>;
+
+}  // namespace dsp
+
+#endif  // BURSTDETECTOR_HPP
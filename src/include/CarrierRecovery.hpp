@@ -0,0 +1,41 @@
+#ifndef CARRIERRECOVERY_HPP
+#define CARRIERRECOVERY_HPP
+
+#include <cstddef>
+
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+struct CarrierRecoveryConfig {
+    float loopBandwidth = 0.02f;  // BnTs на символ
+    float damping = 0.70710678f;  // zeta
+};
+
+// Петля Костаса для QPSK, работает по одному отсчёту на символ. После
+// захвата остаётся неоднозначность фазы на кратное 90°, её снимает
+// FrameSync по известной последовательности.
+class CostasLoop {
+   public:
+    using SampleType = cf32;
+
+    explicit CostasLoop(
+        const CarrierRecoveryConfig& cfg = CarrierRecoveryConfig());
+
+    // Обработка символов на месте.
+    void process(cf32* symbols, size_t count);
+    void reset();
+
+    float phase() const { return phaseEstimate; }
+    float frequency() const { return frequencyEstimate; }
+
+   private:
+    float kp;
+    float ki;
+    float phaseEstimate;
+    float frequencyEstimate;
+};
+
+}  // namespace dsp
+
+#endif  // CARRIERRECOVERY_HPP
@@ -0,0 +1,63 @@
+#ifndef CHAIN_HPP
+#define CHAIN_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+// Блок, обрабатывающий буфер своего типа отсчётов на месте.
+template <typename B>
+concept InPlaceBlock = Sample<typename B::SampleType> &&
+                       requires(B& b, typename B::SampleType* p, size_t n) {
+                           b.process(p, n);
+                       };
+
+// Последовательная цепочка блоков. Между соседними блоками с одинаковым
+// SampleType данные передаются без копирования; преобразование во
+// временный буфер вставляется только там, где типы различаются.
+template <InPlaceBlock... Blocks>
+class Chain {
+   public:
+    explicit Chain(Blocks&... blocks) : blocks(blocks...) {}
+
+    // Возвращает указатель на результат последнего блока: либо `input`,
+    // либо внутренний буфер цепочки (действителен до следующего вызова).
+    template <Sample In>
+    auto* process(In* input, size_t samples) {
+        return step<0>(input, samples);
+    }
+
+   private:
+    template <size_t I, Sample In>
+    auto* step(In* data, size_t samples) {
+        if constexpr (I == sizeof...(Blocks)) {
+            return data;
+        } else {
+            using Block = std::tuple_element_t<I, std::tuple<Blocks...>>;
+            using T = typename Block::SampleType;
+            T* buffer = nullptr;
+            if constexpr (std::same_as<In, T>) {
+                buffer = data;
+            } else {
+                auto& scratch = std::get<I>(scratchBuffers);
+                scratch.resize(bufferLength<T>(samples));
+                convertSamples(data, scratch.data(), samples);
+                buffer = scratch.data();
+            }
+            std::get<I>(blocks).process(buffer, samples);
+            return step<I + 1>(buffer, samples);
+        }
+    }
+
+    std::tuple<Blocks&...> blocks;
+    std::tuple<std::vector<typename Blocks::SampleType>...> scratchBuffers;
+};
+
+}  // namespace dsp
+
+#endif  // CHAIN_HPP
@@ -0,0 +1,114 @@
+#ifndef DSPPLAN_HPP
+#define DSPPLAN_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "FFT.hpp"
+#include "SDRConfig.hpp"
+
+namespace dsp {
+
+struct DSPPlanOptions {
+    size_t fftSize = 1024;         // Размер БПФ монитора спектра
+    double bufferPoolTime = 0.1;   // Глубина пулов буферов, с
+    size_t maxChannelTaps = 255;   // Предел длины канального фильтра
+};
+
+// Геометрия буферов устройства. Размеры пулов — степени двойки (кольца
+// индексируются маской), не меньше двух буферов на направление.
+struct BufferGeometry {
+    uint64_t samplesPerBuffer;
+    uint64_t rxPoolBuffers;
+    uint64_t txPoolBuffers;  // 0, если передатчик не настроен
+};
+
+// Неизменяемый план обработки одного устройства: всё, что вычисляется из
+// SDRConfig один раз и не меняется между запусками, — коэффициенты
+// канальных ФНЧ, таблицы БПФ и размеры пулов буферов.
+//
+// План хранится как непрерывный образ (заголовок и секции, выровненные
+// на 64 байта). Из кэша образ отображается через mmap только для чтения
+// и используется без копирования, в том числе таблицами FFTPlan.
+class DSPPlan {
+   public:
+    static std::shared_ptr<const DSPPlan> compile(
+        const SDRcfg::SDRConfig& sdrConfig,
+        const DSPPlanOptions& options = DSPPlanOptions());
+
+    // Ключ учитывает только поля, от которых зависит план: перестройка
+    // частоты или смена усиления не требуют нового плана.
+    static uint64_t keyOf(const SDRcfg::SDRConfig& sdrConfig,
+                          const DSPPlanOptions& options);
+
+    uint64_t key() const { return planKey; }
+    const BufferGeometry& geometry() const { return bufferGeometry; }
+    std::span<const float> rxChannelTaps() const { return rxTaps; }
+    std::span<const float> txChannelTaps() const { return txTaps; }
+    // План зарегистрирован в общем кэше FFTPlan::get().
+    const std::shared_ptr<const FFTPlan>& fftPlan() const { return fft; }
+    bool fromCache() const { return cached; }
+
+    // Образ плана в формате файла кэша.
+    std::span<const uint8_t> image() const { return bytes; }
+
+    // Разбирает и проверяет образ. `storage` владеет памятью `data`.
+    // Возвращает nullptr, если образ повреждён или ключ не совпадает.
+    static std::shared_ptr<const DSPPlan> fromImage(
+        std::shared_ptr<const void> storage, const uint8_t* data, size_t size,
+        uint64_t expectedKey, bool fromCache);
+
+   private:
+    DSPPlan() = default;
+
+    std::shared_ptr<const void> storage;
+    std::span<const uint8_t> bytes;
+    uint64_t planKey = 0;
+    BufferGeometry bufferGeometry{};
+    std::span<const float> rxTaps;
+    std::span<const float> txTaps;
+    std::shared_ptr<const FFTPlan> fft;
+    bool cached = false;
+};
+
+// Кэш планов на диске: `<directory>/<ключ>.plan`. Файл отображается в
+// память при следующем запуске; при отсутствии или повреждении план
+// компилируется заново и записывается атомарно (временный файл и
+// rename). Ошибки записи не фатальны — план остаётся в памяти.
+class DSPPlanCache {
+   public:
+    explicit DSPPlanCache(std::string directory,
+                          const DSPPlanOptions& options = DSPPlanOptions());
+
+    std::shared_ptr<const DSPPlan> get(const SDRcfg::SDRConfig& sdrConfig);
+
+    uint64_t hits() const { return hitCount.load(); }
+    uint64_t misses() const { return missCount.load(); }
+    uint64_t writeFailures() const { return writeFailureCount.load(); }
+
+   private:
+    std::string pathFor(uint64_t key) const;
+    std::shared_ptr<const DSPPlan> load(const std::string& path,
+                                        uint64_t key) const;
+    bool store(const std::string& path, const DSPPlan& plan) const;
+
+    std::string directory;
+    DSPPlanOptions options;
+    std::mutex mutex;
+    // Планы, уже выданные в этом процессе (несколько устройств с
+    // одинаковыми параметрами делят один план).
+    std::unordered_map<uint64_t, std::shared_ptr<const DSPPlan>> plans;
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+    std::atomic<uint64_t> writeFailureCount{0};
+};
+
+}  // namespace dsp
+
+#endif  // DSPPLAN_HPP
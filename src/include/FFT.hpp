@@ -0,0 +1,49 @@
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dsp {
+
+// Предвычисленный план БПФ (radix-2, in-place). Поворотные множители и
+// таблица бит-реверса считаются один раз в конструкторе.
+class FFTPlan {
+   public:
+    explicit FFTPlan(size_t size);
+    // План на готовых таблицах (n/2 множителей и n индексов), например
+    // отображённых из кэша DSPPlan. `storage` владеет их памятью.
+    FFTPlan(size_t size, const std::complex<float>* twiddles,
+            const uint32_t* bitReverse, std::shared_ptr<const void> storage);
+
+    void execute(std::complex<float>* data) const;
+    size_t size() const { return n; }
+    const std::complex<float>* twiddleTable() const { return twiddles; }
+    const uint32_t* bitReverseTable() const { return bitReverse; }
+
+    // Общий кэш планов: один план на размер на процесс.
+    static std::shared_ptr<const FFTPlan> get(size_t size);
+    // Помещает готовый план в общий кэш, если плана этого размера там ещё
+    // нет. Возвращает план, который будет выдавать get().
+    static std::shared_ptr<const FFTPlan> preload(
+        std::shared_ptr<const FFTPlan> plan);
+
+   private:
+    size_t n;
+    std::shared_ptr<const void> storage;
+    const std::complex<float>* twiddles;
+    const uint32_t* bitReverse;
+};
+
+enum class WindowType { Rectangular, Hann, Hamming, Blackman };
+
+// Кэшированное окно заданного типа и длины.
+std::shared_ptr<const std::vector<float>> getWindow(WindowType type,
+                                                    size_t size);
+
+}  // namespace dsp
+
+#endif  // FFT_HPP
@@ -0,0 +1,40 @@
+#ifndef FIRFILTER_HPP
+#define FIRFILTER_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+// КИХ-фильтр с вещественными коэффициентами для комплексного потока.
+// Хранит хвост предыдущего буфера, поэтому фильтрация непрерывна между
+// вызовами process().
+class FIRFilter {
+   public:
+    using SampleType = cf32;
+
+    explicit FIRFilter(std::vector<float> taps);
+
+    // Обработка на месте.
+    void process(cf32* data, size_t samples);
+    void reset();
+
+    const std::vector<float>& taps() const { return coefficients; }
+
+    // Скользящее среднее длины `length` (согласованный фильтр для
+    // прямоугольного импульса, как в python_examples).
+    static std::vector<float> movingAverage(size_t length);
+    // ФНЧ: окно Хэмминга по sinc, `cutoff` — частота среза в долях
+    // частоты дискретизации (0..0.5), усиление на нуле частоты 1.
+    static std::vector<float> lowPass(double cutoff, size_t length);
+
+   private:
+    std::vector<float> coefficients;  // В обратном порядке
+    std::vector<cf32> work;           // Хвост + текущий буфер
+};
+
+}  // namespace dsp
+
+#endif  // FIRFILTER_HPP
@@ -0,0 +1,45 @@
+#ifndef FRAMESYNC_HPP
+#define FRAMESYNC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+struct FrameSyncDetection {
+    uint64_t symbolIndex;  // Абсолютный номер первого символа кадра
+    cf32 rotation;         // Поворот, на который нужно умножить символы
+    float metric;          // Нормированная корреляция [0, 1]
+};
+
+// Поиск известной последовательности символов в потоке по нормированной
+// корреляции. Для каждой найденной последовательности сообщает фазу
+// (кратную 90°), что снимает неоднозначность петли Костаса.
+class FrameSync {
+   public:
+    explicit FrameSync(std::vector<cf32> syncSymbols, float threshold = 0.8f);
+
+    // Добавляет обнаружения в `detections`, возвращает их число.
+    size_t process(const cf32* symbols, size_t count,
+                   std::vector<FrameSyncDetection>& detections);
+    // Выдаёт кандидата, ожидающего подтверждения (конец потока).
+    size_t flush(std::vector<FrameSyncDetection>& detections);
+    void reset();
+
+   private:
+    std::vector<cf32> reference;  // Сопряжённая эталонная последовательность
+    float referenceEnergy;
+    float threshold;
+
+    std::vector<cf32> history;  // Последние reference.size() - 1 символов
+    uint64_t symbolsSeen;
+    FrameSyncDetection best;
+    bool hasCandidate;
+};
+
+}  // namespace dsp
+
+#endif  // FRAMESYNC_HPP
@@ -1,22 +1,28 @@
 #ifndef SDRDRIVER_HPP
 #define SDRDRIVER_HPP
 
+#include <cstdint>
 #include <memory>
 
 #include "SDRConfig.hpp"
 
 class SDR {
    public:
+    // Родной формат драйвера: чередующиеся I/Q int16 (см. SampleTypes.hpp).
+    using SampleType = int16_t;
+
     SDRcfg::SDRConfig config;
     // TODO: Нужно использовать кольцевые буферы без блокировок который работает
     // на основе атомарных индексов.
-    std::unique_ptr<int16_t[]> rxBuffer;
-    std::unique_ptr<int16_t[]> txBuffer;
+    std::unique_ptr<SampleType[]> rxBuffer;
+    std::unique_ptr<SampleType[]> txBuffer;
 
     explicit SDR(const SDRcfg::SDRConfig& cfg);
     virtual void initialize() = 0;
     virtual void sendSamples() = 0;
     virtual void receiveSamples() = 0;
+    // Аппаратное усиление RX, дБ. Используется программной АРУ.
+    virtual void setGain(double gainDb);
     virtual ~SDR() = default;
 
    protected:
@@ -0,0 +1,133 @@
+#ifndef SAMPLETYPES_HPP
+#define SAMPLETYPES_HPP
+
+#include <algorithm>
+#include <complex>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+namespace dsp {
+
+using cf32 = std::complex<float>;
+
+// Описание поддерживаемых типов отсчётов. Все потоки комплексные:
+// int16_t и float хранят I/Q чередованием (как буферы SDR), cf32 —
+// одним элементом. Количество отсчётов везде считается в комплексных
+// отсчётах, длина буфера в элементах — samples * elementsPerSample.
+template <typename T>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<int16_t> {
+    using Scalar = int16_t;
+    static constexpr size_t elementsPerSample = 2;
+    static constexpr bool isFixedPoint = true;
+    static constexpr float fullScale = 32768.0f;
+
+    static float toFloat(Scalar v) { return static_cast<float>(v) / fullScale; }
+    static Scalar fromFloat(float v) {
+        float s = std::clamp(v * fullScale, -32768.0f, 32767.0f);
+        return static_cast<Scalar>(s + (s >= 0.0f ? 0.5f : -0.5f));
+    }
+};
+
+template <>
+struct SampleTraits<float> {
+    using Scalar = float;
+    static constexpr size_t elementsPerSample = 2;
+    static constexpr bool isFixedPoint = false;
+    static constexpr float fullScale = 1.0f;
+
+    static float toFloat(Scalar v) { return v; }
+    static Scalar fromFloat(float v) { return v; }
+};
+
+template <>
+struct SampleTraits<cf32> {
+    using Scalar = float;
+    static constexpr size_t elementsPerSample = 1;
+    static constexpr bool isFixedPoint = false;
+    static constexpr float fullScale = 1.0f;
+
+    static float toFloat(Scalar v) { return v; }
+    static Scalar fromFloat(float v) { return v; }
+};
+
+template <typename T>
+concept Sample = requires {
+    typename SampleTraits<T>::Scalar;
+    { SampleTraits<T>::elementsPerSample } -> std::convertible_to<size_t>;
+};
+
+template <Sample T>
+constexpr size_t bufferLength(size_t samples) {
+    return samples * SampleTraits<T>::elementsPerSample;
+}
+
+// Вид буфера как массива скаляров I, Q, I, Q, ...
+template <Sample T>
+typename SampleTraits<T>::Scalar* scalars(T* data) {
+    return reinterpret_cast<typename SampleTraits<T>::Scalar*>(data);
+}
+
+template <Sample T>
+const typename SampleTraits<T>::Scalar* scalars(const T* data) {
+    return reinterpret_cast<const typename SampleTraits<T>::Scalar*>(data);
+}
+
+// Преобразование между типами. Для одинаковых типов — простое копирование.
+template <Sample From, Sample To>
+void convertSamples(const From* in, To* out, size_t samples) {
+    if constexpr (std::same_as<From, To>) {
+        std::copy_n(in, bufferLength<From>(samples), out);
+    } else {
+        const auto* src = scalars(in);
+        auto* dst = scalars(out);
+        for (size_t i = 0; i < 2 * samples; ++i) {
+            dst[i] = SampleTraits<To>::fromFloat(
+                SampleTraits<From>::toFloat(src[i]));
+        }
+    }
+}
+
+// Сумма |x|^2 по `samples` комплексным отсчётам в долях полной шкалы.
+// Для int16 — целочисленное накопление, для float — частичные суммы по
+// полосам: оба варианта векторизуются компилятором без -ffast-math.
+template <Sample T>
+float sumOfSquares(const T* iq, size_t samples) {
+    using Traits = SampleTraits<T>;
+    const auto* data = scalars(iq);
+    size_t n = 2 * samples;
+    if constexpr (Traits::isFixedPoint) {
+        int64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int32_t v = data[i];
+            acc += v * v;
+        }
+        double fullScale = Traits::fullScale;
+        return static_cast<float>(static_cast<double>(acc) /
+                                  (fullScale * fullScale));
+    } else {
+        constexpr size_t kLanes = 8;
+        float partial[kLanes] = {};
+        size_t i = 0;
+        for (; i + kLanes <= n; i += kLanes) {
+            for (size_t l = 0; l < kLanes; ++l) {
+                partial[l] += data[i + l] * data[i + l];
+            }
+        }
+        float sum = 0.0f;
+        for (; i < n; ++i) {
+            sum += data[i] * data[i];
+        }
+        for (size_t l = 0; l < kLanes; ++l) {
+            sum += partial[l];
+        }
+        return sum;
+    }
+}
+
+}  // namespace dsp
+
+#endif  // SAMPLETYPES_HPP
@@ -0,0 +1,83 @@
+#ifndef SHAREDMEMORYTAP_HPP
+#define SHAREDMEMORYTAP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "SDRConfig.hpp"
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+enum class SharedSampleFormat : uint32_t { Int16IQ = 0, Float32IQ = 1 };
+
+// Заголовок кольца в разделяемой памяти (little-endian). Данные начинаются
+// со смещения `dataOffset`, длина кольца — `capacity` комплексных отсчётов.
+// `writeIndex` монотонно растёт и считается в отсчётах; позиция в кольце —
+// writeIndex % capacity. Перед копированием данных писатель публикует
+// `writeBegin` — конец записи, которая сейчас идёт: слоты до
+// writeBegin - capacity могут быть уже перезаписаны, даже если writeIndex
+// ещё не изменился. Формат описан в src/DSP/README.md.
+struct SharedRingHeader {
+    uint32_t magic;           // SHARED_RING_MAGIC
+    uint16_t version;         // SHARED_RING_VERSION
+    uint16_t dataOffset;      // Смещение данных от начала сегмента
+    uint32_t sampleFormat;    // SharedSampleFormat
+    uint32_t bytesPerSample;  // Байт на комплексный отсчёт
+    uint64_t capacity;        // Длина кольца в отсчётах (степень двойки)
+    double sampleRate;        // Частота выборки RX, Гц
+    double frequency;         // Частота RX, Гц
+    uint8_t reserved[16];
+    std::atomic<uint64_t> writeBegin;   // Конец текущей (начатой) записи
+    std::atomic<uint64_t> writeIndex;   // Всего записано отсчётов
+    std::atomic<uint64_t> timestampNs;  // Метка времени последней записи
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(sizeof(SharedRingHeader) == 80);
+
+inline constexpr uint32_t SHARED_RING_MAGIC = 0x52585254;  // "TRXR"
+inline constexpr uint16_t SHARED_RING_VERSION = 2;
+inline constexpr uint16_t SHARED_RING_DATA_OFFSET = 4096;
+
+// Публикует поток в именованное кольцо POSIX shared memory. Запись никогда
+// не ждёт читателей: медленный читатель просто теряет перезаписанные данные
+// и обнаруживает это по writeBegin.
+template <Sample T>
+class SharedMemoryTap {
+   public:
+    using SampleType = T;
+
+    // `name` — имя сегмента для shm_open, например "/trx_sdr1".
+    SharedMemoryTap(const std::string& name, const SDRcfg::SDRConfig& sdrConfig,
+                    size_t capacitySamples, bool unlinkOnClose = true);
+    ~SharedMemoryTap();
+    SharedMemoryTap(const SharedMemoryTap&) = delete;
+    SharedMemoryTap& operator=(const SharedMemoryTap&) = delete;
+
+    void push(const T* iq, size_t samples, uint64_t timestampNs);
+    // Для Chain: данные не изменяются, метка времени — текущее время.
+    void process(T* iq, size_t samples);
+
+    size_t capacity() const { return capacitySamples; }
+    uint64_t written() const;
+
+   private:
+    std::string name;
+    size_t capacitySamples;
+    size_t mappedSize;
+    bool unlinkOnClose;
+    int fd;
+    void* mapping;
+    SharedRingHeader* header;
+    uint8_t* data;
+};
+
+extern template class SharedMemoryTap<int16_t>;
+extern template class SharedMemoryTap<float>;
+extern template class SharedMemoryTap<cf32>;
+
+}  // namespace dsp
+
+#endif  // SHAREDMEMORYTAP_HPP
@@ -0,0 +1,114 @@
+#ifndef SPECTRUMTAP_HPP
+#define SPECTRUMTAP_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FFT.hpp"
+#include "SDRConfig.hpp"
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+enum class SpectrumSinkType { None, File, UnixSocket };
+
+// Заголовок кадра спектра. За ним следуют `bins` значений float32 в дБ,
+// упорядоченных от -fs/2 до +fs/2 (DC в центре).
+struct SpectrumFrameHeader {
+    uint32_t magic;           // SPECTRUM_FRAME_MAGIC
+    uint16_t version;         // SPECTRUM_FRAME_VERSION
+    uint16_t headerSize;      // sizeof(SpectrumFrameHeader)
+    uint32_t bins;            // Количество бинов
+    uint32_t averages;        // Количество усреднённых сегментов
+    uint64_t sequence;        // Номер кадра
+    uint64_t timestampNs;     // Метка времени первого сегмента
+    double centerFrequency;   // Центральная частота, Гц
+    double sampleRate;        // Частота выборки, Гц
+};
+static_assert(sizeof(SpectrumFrameHeader) == 48);
+
+inline constexpr uint32_t SPECTRUM_FRAME_MAGIC = 0x53585254;  // "TRXS"
+inline constexpr uint16_t SPECTRUM_FRAME_VERSION = 1;
+
+struct SpectrumTapConfig {
+    size_t fftSize = 1024;     // Размер БПФ (степень двойки)
+    size_t averages = 8;       // Сегментов Уэлча на кадр
+    double overlap = 0.5;      // Перекрытие сегментов [0, 1)
+    size_t decimation = 16;    // Обрабатывается 1 буфер из N
+    WindowType window = WindowType::Hann;
+    SpectrumSinkType sinkType = SpectrumSinkType::None;
+    std::string sinkPath;      // Файл или путь AF_UNIX сокета
+};
+
+// Приёмник кадров: файл или датаграммный unix-сокет. Запись в сокет
+// неблокирующая, при переполнении кадр отбрасывается.
+class SpectrumSink {
+   public:
+    SpectrumSink(SpectrumSinkType type, const std::string& path);
+    ~SpectrumSink();
+    SpectrumSink(const SpectrumSink&) = delete;
+    SpectrumSink& operator=(const SpectrumSink&) = delete;
+
+    bool write(const void* data, size_t size);
+
+   private:
+    SpectrumSinkType type;
+    std::string path;
+    std::ofstream file;
+    int socketFd;
+};
+
+// Монитор спектра (СПМ по Уэлчу). Подключается к любому потоку через push().
+// Обрабатывает только каждый `decimation`-й буфер, остальные отбрасываются
+// сразу, что держит нагрузку на уровне единиц процентов. Сегменты берутся
+// внутри одного буфера, поэтому `bufferSize` из SDRConfig должен быть не
+// меньше `fftSize`.
+class SpectrumTap {
+   public:
+    SpectrumTap(const SDRcfg::SDRConfig& sdrConfig,
+                const SpectrumTapConfig& cfg);
+
+    // `samples` — число комплексных отсчётов любого типа из SampleTypes.
+    template <Sample T>
+    void push(const T* iq, size_t samples, uint64_t timestampNs);
+
+    const std::vector<float>& lastFrame() const { return frameDb; }
+    uint64_t framesPublished() const { return sequence; }
+
+   private:
+    void publish();
+    // Смещение отсчёта `offset` от начала буфера, нс.
+    uint64_t segmentOffsetNs(size_t offset) const;
+
+    SpectrumTapConfig cfg;
+    double centerFrequency;
+    double sampleRate;
+    size_t hop;
+    float scale;
+
+    std::shared_ptr<const FFTPlan> plan;
+    std::shared_ptr<const std::vector<float>> window;
+    std::vector<cf32> segment;
+    std::vector<float> accum;
+    std::vector<float> frameDb;
+    std::vector<uint8_t> frameBuffer;
+    std::unique_ptr<SpectrumSink> sink;
+
+    size_t bufferCounter;
+    size_t segmentsAccumulated;
+    uint64_t frameTimestampNs;
+    uint64_t sequence;
+};
+
+extern template void SpectrumTap::push<int16_t>(const int16_t*, size_t,
+                                               uint64_t);
+extern template void SpectrumTap::push<float>(const float*, size_t,
+                                             uint64_t);
+extern template void SpectrumTap::push<cf32>(const cf32*, size_t, uint64_t);
+
+}  // namespace dsp
+
+#endif  // SPECTRUMTAP_HPP
@@ -1,20 +1,26 @@
 #ifndef THREAD_MANAGER_HPP
 #define THREAD_MANAGER_HPP
 
+#include <array>
 #include <atomic>
 #include <bitset>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "TimerWheel.hpp"
+
 // #define DEBUG
 #ifdef DEBUG
 #define LOG(msg) std::cout << msg << std::endl
@@ -28,30 +34,104 @@
 #define MAX_THREAD_GROUP 100
 #endif
 
+class TaskGraph;
+class GraphRun;
+
+// Признак отмены задач группы, который выполняющаяся задача может
+// опрашивать. Токен отменяется вызовом stopGroup()/cancelGroup() для его
+// группы и действителен, пока жив выдавший его ThreadManager.
+// Токен по умолчанию никогда не отменяется.
+class CancellationToken {
+   public:
+    CancellationToken() = default;
+    bool cancelled() const {
+        return epoch != nullptr &&
+               epoch->load(std::memory_order_acquire) != issuedEpoch;
+    }
+
+   private:
+    friend class ThreadManager;
+    CancellationToken(const std::atomic<uint64_t>* epoch,
+                      uint64_t issuedEpoch)
+        : epoch(epoch), issuedEpoch(issuedEpoch) {}
+
+    const std::atomic<uint64_t>* epoch = nullptr;
+    uint64_t issuedEpoch = 0;
+};
+
 class ThreadManager {
    public:
     using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+    using TimerID = TimerWheel::TimerID;
     enum class TaskPriority { High, Normal, Low };
     struct TaskEntry {
         std::shared_ptr<std::packaged_task<size_t()>> task;
         TaskPriority priority;
         size_t groupID;
+        // Эпоха группы при постановке в очередь. Задачи устаревших эпох
+        // снимаются при извлечении из очереди.
+        uint64_t epoch;
         size_t taskID;
+        // Вызывается вместо задачи, если она снята с выполнения.
+        std::function<void()> onCancel;
         bool operator>(const TaskEntry& other) const {
             return priority > other.priority;
         }
     };
 
+    // Пул эластичный: потоки создаются по мере накопления очереди (не
+    // больше `maxThreads`) и завершаются, простояв `idleTimeout`, пока их
+    // больше `minThreads`.
     ThreadManager(size_t maxThreads = std::thread::hardware_concurrency(),
-                  bool roundRobin = false);
-    ThreadManager();
+                  bool roundRobin = false, size_t minThreads = 0,
+                  std::chrono::milliseconds idleTimeout =
+                      std::chrono::milliseconds(1000));
+    ~ThreadManager();
     template <typename Func, typename... Args>
     size_t addTask(Func&& func, Args&&... args,
                    TaskPriority priority = TaskPriority::Normal,
                    size_t groupID = 0);
     void stopAll();
+    // Отменяет задачи группы в очереди и токены выполняющихся задач, новые
+    // задачи группы также снимаются до вызова resumeGroup(). O(1): очередь
+    // не перестраивается, устаревшие задачи отбрасываются при извлечении.
     void stopGroup(size_t groupID);
+    // Как stopGroup(), но группа продолжает принимать новые задачи.
+    void cancelGroup(size_t groupID);
+    void resumeGroup(size_t groupID);
+    // Токен отмены для текущей эпохи группы.
+    CancellationToken cancellationToken(size_t groupID) const;
+    // Токен задачи, выполняемой в вызывающем потоке пула.
+    static CancellationToken currentToken();
+    // Ожидает, пока в группе не останется задач в очереди и в работе.
+    void waitForGroup(size_t groupID);
     void resizeThreadPool(size_t newSize);
+    // Завершает `count` потоков по мере их освобождения. Выполняемые задачи
+    // не прерываются, последний поток не уходит, пока очередь не пуста.
+    void retireWorkers(size_t count);
+    // Запуск графа задач. Узлы без предшественников ставятся в очередь
+    // сразу, остальные — как только завершатся все их предшественники.
+    // `continuation` вызывается после завершения всех узлов.
+    std::shared_ptr<GraphRun> runGraph(
+        const TaskGraph& graph, size_t groupID = 0,
+        std::function<void()> continuation = nullptr);
+    // Таймеры с разрешением 1 мкс. В срок задача ставится в очередь пула
+    // с указанным приоритетом и группой; отмена группы снимает и её
+    // таймеры. Отдельный поток таймеров спит на timerfd и досыпает
+    // последние микросекунды активным ожиданием. Возвращают 0 при ошибке.
+    TimerID scheduleAt(Clock::time_point when, Task task,
+                       TaskPriority priority = TaskPriority::Normal,
+                       size_t groupID = 0);
+    TimerID scheduleAfter(std::chrono::microseconds delay, Task task,
+                          TaskPriority priority = TaskPriority::Normal,
+                          size_t groupID = 0);
+    // Первый запуск через `period`, далее с фиксированным шагом от
+    // исходного срока; пропущенные периоды не наверстываются.
+    TimerID scheduleEvery(std::chrono::microseconds period, Task task,
+                          TaskPriority priority = TaskPriority::Normal,
+                          size_t groupID = 0);
+    bool cancelTimer(TimerID timerID);
     std::unordered_map<size_t, size_t> waitForAll();
     size_t waitForTask(size_t taskID);
     size_t getActiveThreads();
@@ -59,11 +139,38 @@ class ThreadManager {
     size_t getBusyWorkers();
 
    private:
+    struct TimerEntry {
+        std::shared_ptr<Task> task;
+        uint64_t expiry;  // мкс CLOCK_MONOTONIC
+        uint64_t period;  // 0 — однократный
+        TaskPriority priority;
+        size_t groupID;
+        uint64_t epoch;
+    };
+
     void workerThread();
     void startWorkerIfNecessary();
+    bool shouldRetire(bool idleTimedOut) const;
+    void retireCurrentWorker();
+    void joinFinishedThreads();
+    void setGroupRunning(size_t groupID, bool value);
+    bool isStale(const TaskEntry& entry) const;
+    void finishTask(size_t groupID);
+    void enqueue(TaskEntry entry);
+    void enqueueGraphNode(const std::shared_ptr<GraphRun>& run, size_t node);
+    void executeGraphNode(const std::shared_ptr<GraphRun>& run, size_t node,
+                          bool cancelled);
+    TimerID addTimer(uint64_t expiry, uint64_t period, Task task,
+                     TaskPriority priority, size_t groupID);
+    bool startTimerThread();
+    void stopTimerThread();
+    void timerThreadLoop();
+    void waitForTimer(std::optional<uint64_t> tick, bool expiry);
+    static uint64_t toTimerTick(Clock::time_point time);
 
     // container
-    std::vector<std::thread> threads;
+    std::unordered_map<std::thread::id, std::thread> threads;
+    std::vector<std::thread> finishedThreads;  // Завершившиеся, ждут join
     std::priority_queue<TaskEntry, std::vector<TaskEntry>,
                         std::greater<TaskEntry>>
         taskQueue;
@@ -76,15 +183,36 @@ class ThreadManager {
     std::atomic<size_t> busyWorkers;
     std::atomic<size_t> nextTaskID;
     std::atomic<std::bitset<MAX_THREAD_GROUP>> groupRunning;
+    std::array<std::atomic<uint64_t>, MAX_THREAD_GROUP> groupEpoch{};
+    // Задачи группы в очереди и в работе (под queueMutex).
+    std::array<size_t, MAX_THREAD_GROUP> groupPending{};
+
+    static thread_local CancellationToken currentTaskToken;
 
     // pupupu
     size_t maxThreads;
     bool roundRobin;
+    size_t minThreads;
+    std::chrono::milliseconds idleTimeout;
+    size_t pendingRetirements;
 
     // sync
     std::mutex queueMutex;
     std::mutex resultMutex;
     std::condition_variable cv;
+    std::condition_variable doneCv;  // Для waitForAll
+
+    // timers
+    std::thread timerThread;
+    std::mutex timerMutex;
+    TimerWheel timerWheel;
+    std::unordered_map<TimerID, TimerEntry> timers;
+    TimerID nextTimerID;
+    uint64_t timerNextTick;  // Срок, на который заведён timerfd
+    bool timerRunning;
+    bool timerStopping;  // stopAll() начат: новые таймеры не принимаются
+    int timerFd;
+    int timerWakeFd;  // eventfd: пробуждение при более раннем таймере
 };
 
 template <typename Func, typename... Args>
@@ -101,8 +229,15 @@ size_t ThreadManager::addTask(Func&& func, Args&&... args,
     size_t taskID = nextTaskID++;
     {
         std::lock_guard<std::mutex> lock(queueMutex);
-        taskQueue.push(TaskEntry{packagedTask, priority, groupID, taskID});
+        if (!running.load()) {
+            ERROR("ThreadManager is stopped, task rejected");
+            return 0;
+        }
+        taskQueue.push(TaskEntry{packagedTask, priority, groupID,
+                                 groupEpoch[groupID].load(), taskID,
+                                 nullptr});
         tasksInQueue++;
+        groupPending[groupID]++;
         taskResults[taskID] = std::move(future);
     }
     cv.notify_one();
@@ -113,4 +248,71 @@ size_t ThreadManager::addTask(Func&& func, Args&&... args,
     return taskID;
 }
 
+// Граф зависимостей задач. Узлы добавляются с уже существующими
+// предшественниками, поэтому граф всегда ацикличен. Один граф можно
+// запускать многократно (например, на каждый буфер) без перестроения,
+// в том числе параллельно: каждый запуск получает своё состояние.
+class TaskGraph {
+   public:
+    using NodeID = size_t;
+    using Task = ThreadManager::Task;
+    using TaskPriority = ThreadManager::TaskPriority;
+
+    TaskGraph();
+    NodeID addNode(Task task, const std::vector<NodeID>& predecessors = {},
+                   TaskPriority priority = TaskPriority::Normal);
+    void precede(NodeID before, NodeID after);
+    // Вызывается после каждого завершённого запуска графа.
+    void onComplete(Task callback);
+    size_t size() const;
+
+   private:
+    friend class ThreadManager;
+    friend class GraphRun;
+    struct Node {
+        Task task;
+        TaskPriority priority;
+        std::vector<NodeID> successors;
+        size_t predecessors;
+    };
+    struct Data {
+        std::vector<Node> nodes;
+        std::vector<Task> completionCallbacks;
+    };
+    Data& mutableData();
+
+    // Копирование при записи: запущенные графы не видят изменений.
+    std::shared_ptr<Data> data;
+};
+
+// Состояние одного запуска графа.
+class GraphRun {
+   public:
+    // Ожидает завершения всех узлов. Возвращает false, если часть узлов
+    // была снята с выполнения; исключение первого упавшего узла
+    // пробрасывается.
+    bool wait();
+    bool done() const;
+
+   private:
+    friend class ThreadManager;
+    GraphRun(std::shared_ptr<const TaskGraph::Data> graph, size_t groupID,
+             uint64_t epoch, std::function<void()> continuation);
+    void finish();
+
+    std::shared_ptr<const TaskGraph::Data> graph;
+    size_t groupID;
+    uint64_t epoch;  // Эпоха группы на момент запуска
+    std::function<void()> continuation;
+    std::unique_ptr<std::atomic<size_t>[]> pending;
+    std::atomic<size_t> remaining;
+    std::atomic<bool> failed;
+    std::atomic<bool> cancelled;
+    std::exception_ptr error;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    bool finished;
+};
+
 #endif  // THREAD_MANAGER_HPP
\ No newline at end of file
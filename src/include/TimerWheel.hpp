@@ -0,0 +1,74 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Иерархическое колесо таймеров. Время — целые такты (в ThreadManager
+// такт равен 1 мкс). Четыре уровня по 256 слотов покрывают 2^32 тактов,
+// более дальние таймеры перекладываются при каждом обороте верхнего
+// уровня. Вставка O(1), продвижение пропорционально числу занятых слотов
+// и пройденных границ младшего уровня.
+//
+// Колесо не потокобезопасно и не хранит полезную нагрузку: только
+// идентификаторы и сроки. Снятие таймеров выполняет владелец, игнорируя
+// идентификаторы, которых у него больше нет.
+class TimerWheel {
+   public:
+    using TimerID = uint64_t;
+
+    explicit TimerWheel(uint64_t startTick = 0);
+
+    // Таймеры со сроком в прошлом, в том числе на последнем пройденном
+    // такте, выдаются ближайшим advance() при любом nowTick.
+    void insert(TimerID id, uint64_t expiryTick);
+    // Добавляет в `expired` все таймеры со сроком <= nowTick.
+    void advance(uint64_t nowTick, std::vector<TimerID>& expired);
+    // Ближайший такт, на котором advance() может что-то выдать или
+    // переложить таймеры между уровнями. Пусто, если таймеров нет.
+    std::optional<uint64_t> nextTick() const;
+    // Истина, если nextTick() — срок таймера, а не перекладка уровней.
+    bool nextTickIsExpiry() const;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+   private:
+    static constexpr size_t kLevels = 4;
+    static constexpr size_t kSlotBits = 8;
+    static constexpr size_t kSlots = size_t(1) << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+
+    struct Entry {
+        TimerID id;
+        uint64_t expiry;
+    };
+    struct Level {
+        std::array<std::vector<Entry>, kSlots> slots;
+        std::array<uint64_t, kSlots / 64> occupied{};
+    };
+
+    struct Event {
+        uint64_t tick;
+        bool expiry;
+    };
+    // Ближайшее событие начиная с такта `from`.
+    std::optional<Event> nextEvent(uint64_t from) const;
+    void place(const Entry& entry);
+    void cascade();
+    void fireCurrent(std::vector<TimerID>& expired);
+    // Первый занятый слот уровня с индексом >= from (без перехода через 0).
+    static std::optional<size_t> findOccupied(const Level& level,
+                                              size_t from);
+    static void mark(Level& level, size_t slot);
+    static void unmark(Level& level, size_t slot);
+
+    std::array<Level, kLevels> levels;
+    std::vector<Entry> overdue;  // Вставлены со сроком < current
+    uint64_t current;  // Слоты с тактами < current уже выданы
+    size_t count;
+};
+
+#endif  // TIMER_WHEEL_HPP
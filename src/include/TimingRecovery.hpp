@@ -0,0 +1,45 @@
+#ifndef TIMINGRECOVERY_HPP
+#define TIMINGRECOVERY_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "SampleTypes.hpp"
+
+namespace dsp {
+
+struct TimingRecoveryConfig {
+    size_t samplesPerSymbol = 10;
+    float loopBandwidth = 0.01f;  // BnTs
+    float damping = 0.70710678f;  // zeta
+    float detectorGain = 2.7f;    // Kp
+};
+
+// Символьная синхронизация с детектором Гарднера, как в
+// python_examples/receive/main.py. Работает потоково: недообработанный
+// хвост буфера переносится в следующий вызов.
+class GardnerTimingRecovery {
+   public:
+    explicit GardnerTimingRecovery(
+        const TimingRecoveryConfig& cfg = TimingRecoveryConfig());
+
+    // Добавляет найденные символы в конец `symbols`, возвращает их число.
+    size_t process(const cf32* samples, size_t count,
+                   std::vector<cf32>& symbols);
+    void reset();
+
+    int offset() const { return tau; }
+
+   private:
+    size_t sps;
+    float k1;
+    float k2;
+    float integrator;
+    int tau;
+    size_t nextIndex;  // Позиция следующего символа в `buffer`
+    std::vector<cf32> buffer;
+};
+
+}  // namespace dsp
+
+#endif  // TIMINGRECOVERY_HPP
@@ -0,0 +1,122 @@
+// Регрессии остановки ThreadManager, пока задачи ещё выполняются: раньше
+// и узлы графа, и таймеры, поставленные из задач, создавали потоки после
+// того, как stopAll() начал их собирать, и процесс падал в std::terminate.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "ThreadManager.hpp"
+
+namespace {
+
+bool runFanOut(int iteration) {
+    std::atomic<size_t> executed{0};
+    std::atomic<bool> continued{false};
+    TaskGraph graph;
+    auto sleepTask = [&executed] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        executed++;
+    };
+    TaskGraph::NodeID root = graph.addNode(sleepTask);
+    for (size_t i = 0; i < 8; ++i) {
+        graph.addNode(sleepTask, {root});
+    }
+
+    std::shared_ptr<GraphRun> run;
+    {
+        ThreadManager manager(4);
+        run = manager.runGraph(graph, 0, [&continued] { continued = true; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    // Запуск должен завершиться: узлы, не принятые остановленным пулом,
+    // проходят по пути отмены.
+    if (!run || !run->done() || !continued.load()) {
+        std::cerr << "Iteration " << iteration
+                  << ": graph run did not finish after shutdown\n";
+        return false;
+    }
+    bool complete = run->wait();
+    if (complete != (executed.load() == graph.size())) {
+        std::cerr << "Iteration " << iteration << ": wait() returned "
+                  << complete << " with " << executed.load() << " of "
+                  << graph.size() << " nodes executed\n";
+        return false;
+    }
+    return true;
+}
+
+// Задачи пула ставят таймеры, пока идёт stopAll() (или деструктор).
+// Раньше addTimer() между остановкой потока таймеров и его join
+// перезапускал поток поверх ещё не присоединённого std::thread.
+bool timersDuringStop(int iteration, bool destroy) {
+    constexpr size_t kTasks = 4;
+    constexpr size_t kMaxAttempts = 10000000;
+    std::atomic<size_t> rejected{0};
+    std::atomic<bool> exhausted{false};
+    auto manager = std::make_unique<ThreadManager>(kTasks);
+    ThreadManager* tm = manager.get();
+    for (size_t i = 0; i < kTasks; ++i) {
+        manager->addTask([tm, &rejected, &exhausted]() -> size_t {
+            for (size_t attempt = 0; attempt < kMaxAttempts; ++attempt) {
+                if (tm->scheduleAfter(std::chrono::seconds(1), [] {}) == 0) {
+                    rejected++;
+                    return 0;
+                }
+            }
+            exhausted = true;
+            return 0;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    if (destroy) {
+        manager.reset();
+    } else {
+        manager->stopAll();
+    }
+    // После остановки таймеры не принимаются.
+    if (!destroy && manager->scheduleAfter(std::chrono::seconds(1), [] {}) !=
+                        0) {
+        std::cerr << "Iteration " << iteration
+                  << ": timer accepted after stopAll()\n";
+        return false;
+    }
+    if (exhausted.load() || rejected.load() != kTasks) {
+        std::cerr << "Iteration " << iteration << ": " << rejected.load()
+                  << " of " << kTasks << " tasks saw their timer rejected\n";
+        return false;
+    }
+    return true;
+}
+
+bool addTaskAfterStop() {
+    ThreadManager manager(2);
+    manager.stopAll();
+    if (manager.addTask([]() -> size_t { return 1; }) != 0) {
+        std::cerr << "addTask accepted a task after stopAll()\n";
+        return false;
+    }
+    return manager.getActiveThreads() == 0;
+}
+
+}  // namespace
+
+int main() {
+    for (int i = 0; i < 50; ++i) {
+        if (!runFanOut(i)) {
+            return 1;
+        }
+    }
+    for (int i = 0; i < 100; ++i) {
+        if (!timersDuringStop(i, i % 2 == 1)) {
+            return 1;
+        }
+    }
+    if (!addTaskAfterStop()) {
+        return 1;
+    }
+    std::cout << "ThreadManager shutdown test passed\n";
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Проверка таймеров ThreadManager: scheduleAfter()/scheduleAt() срабатывают
+// не раньше срока, отменённые таймеры (cancelTimer() и cancelGroup()) не
+// срабатывают, периодический таймер останавливается отменой.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "ThreadManager.hpp"
+
+namespace {
+
+using Clock = ThreadManager::Clock;
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << "\n";
+        ++failures;
+    }
+}
+
+// Ждёт условия не дольше `limit`: срок срабатывания зависит от загрузки
+// машины, поэтому проверяется только, что таймер сработал и не раньше срока.
+template <typename Predicate>
+bool waitFor(Predicate predicate,
+             std::chrono::milliseconds limit = std::chrono::seconds(2)) {
+    auto deadline = Clock::now() + limit;
+    while (!predicate()) {
+        if (Clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+}
+
+// Срок и текущее время переводятся в такты по 1 мкс с округлением вверх,
+// поэтому в пределах одного такта срабатывание может опередить срок.
+bool notEarly(Clock::rep firedAt, Clock::time_point when) {
+    Clock::time_point fired{Clock::duration(firedAt)};
+    return fired + std::chrono::microseconds(1) >= when;
+}
+
+void testScheduleAfter(ThreadManager& manager) {
+    std::atomic<Clock::rep> firedAt{0};
+    auto start = Clock::now();
+    auto id = manager.scheduleAfter(std::chrono::milliseconds(2), [&firedAt] {
+        firedAt = Clock::now().time_since_epoch().count();
+    });
+    check(id != 0, "scheduleAfter accepted");
+    check(waitFor([&firedAt] { return firedAt.load() != 0; }),
+          "scheduleAfter fired");
+    check(notEarly(firedAt.load(), start + std::chrono::milliseconds(2)),
+          "scheduleAfter not early");
+}
+
+void testScheduleAt(ThreadManager& manager) {
+    std::atomic<Clock::rep> firedAt{0};
+    auto when = Clock::now() + std::chrono::milliseconds(3);
+    auto id = manager.scheduleAt(when, [&firedAt] {
+        firedAt = Clock::now().time_since_epoch().count();
+    });
+    check(id != 0, "scheduleAt accepted");
+    check(waitFor([&firedAt] { return firedAt.load() != 0; }),
+          "scheduleAt fired");
+    check(notEarly(firedAt.load(), when), "scheduleAt not early");
+}
+
+void testCancelTimer(ThreadManager& manager) {
+    std::atomic<int> cancelledRuns{0};
+    std::atomic<bool> marker{false};
+    auto id = manager.scheduleAfter(std::chrono::milliseconds(5),
+                                    [&cancelledRuns] { cancelledRuns++; });
+    check(manager.cancelTimer(id), "cancelTimer removes a pending timer");
+    check(!manager.cancelTimer(id), "cancelTimer twice");
+    // Маркер позже срока отменённого таймера.
+    manager.scheduleAfter(std::chrono::milliseconds(20),
+                          [&marker] { marker = true; });
+    check(waitFor([&marker] { return marker.load(); }), "marker fired");
+    manager.waitForAll();
+    check(cancelledRuns.load() == 0, "cancelled timer did not fire");
+}
+
+void testPeriodic(ThreadManager& manager) {
+    std::atomic<int> runs{0};
+    auto id = manager.scheduleEvery(std::chrono::milliseconds(1),
+                                    [&runs] { runs++; });
+    check(id != 0, "scheduleEvery accepted");
+    check(waitFor([&runs] { return runs.load() >= 3; }),
+          "periodic timer fired three times");
+    check(manager.cancelTimer(id), "cancelTimer stops a periodic timer");
+    // Уже поставленный в очередь запуск может завершиться после отмены.
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    manager.waitForAll();
+    int stopped = runs.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    manager.waitForAll();
+    check(runs.load() == stopped, "periodic timer stopped after cancel");
+}
+
+void testCancelGroup(ThreadManager& manager) {
+    constexpr size_t kGroup = 3;
+    std::atomic<int> groupRuns{0};
+    std::atomic<bool> marker{false};
+    auto id = manager.scheduleAfter(
+        std::chrono::milliseconds(5), [&groupRuns] { groupRuns++; },
+        ThreadManager::TaskPriority::Normal, kGroup);
+    check(id != 0, "group timer accepted");
+    manager.cancelGroup(kGroup);
+    manager.scheduleAfter(std::chrono::milliseconds(20),
+                          [&marker] { marker = true; });
+    check(waitFor([&marker] { return marker.load(); }), "marker fired");
+    manager.waitForAll();
+    check(groupRuns.load() == 0, "timer of a cancelled group did not fire");
+    check(!manager.cancelTimer(id), "cancelled group timer is gone");
+}
+
+}  // namespace
+
+int main() {
+    {
+        ThreadManager manager(2);
+        testScheduleAfter(manager);
+        testScheduleAt(manager);
+        testCancelTimer(manager);
+        testPeriodic(manager);
+        testCancelGroup(manager);
+    }
+    if (failures != 0) {
+        std::cerr << failures << " timer scheduler checks failed\n";
+        return 1;
+    }
+    std::cout << "Timer scheduler test passed\n";
+    return 0;
+}
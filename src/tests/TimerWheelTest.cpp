@@ -0,0 +1,207 @@
+// Детерминированные проверки TimerWheel: перекладка между уровнями,
+// вставка на текущий и прошедший такт, снятие таймеров владельцем,
+// периодический перезапуск и сверка со сравнительной моделью.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "TimerWheel.hpp"
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what, uint64_t detail = 0) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << " (" << detail << ")\n";
+        ++failures;
+    }
+}
+
+// Продвигает колесо по nextTick() и запоминает такт срабатывания каждого
+// таймера. Перед каждым шагом проверяется, что на такт раньше ничего не
+// срабатывает.
+std::map<TimerWheel::TimerID, uint64_t> drain(TimerWheel& wheel) {
+    std::map<TimerWheel::TimerID, uint64_t> fired;
+    std::vector<TimerWheel::TimerID> expired;
+    while (!wheel.empty()) {
+        uint64_t tick = *wheel.nextTick();
+        if (tick > 0) {
+            wheel.advance(tick - 1, expired);
+            check(expired.empty(), "timer fired before its tick", tick);
+        }
+        wheel.advance(tick, expired);
+        for (TimerWheel::TimerID id : expired) {
+            fired[id] = tick;
+        }
+        expired.clear();
+    }
+    return fired;
+}
+
+void testCascade() {
+    // Старт у границы третьего уровня: сроки пересекают границы всех
+    // уровней, последний — за пределами охвата колеса (2^32 тактов).
+    const uint64_t start = (uint64_t(1) << 24) - 3;
+    const std::vector<uint64_t> deltas = {
+        0,       1,         2,         3,          255,
+        256,     257,       65535,     65536,      65537,
+        1 << 20, 16777216,  16777217,  4294967295, 4294967296,
+        (uint64_t(1) << 32) + 12345, (uint64_t(1) << 34) + 7};
+    TimerWheel wheel(start);
+    for (size_t i = 0; i < deltas.size(); ++i) {
+        wheel.insert(i + 1, start + deltas[i]);
+    }
+    check(wheel.size() == deltas.size(), "size after inserts", wheel.size());
+    auto fired = drain(wheel);
+    check(fired.size() == deltas.size(), "all timers fired", fired.size());
+    for (size_t i = 0; i < deltas.size(); ++i) {
+        auto it = fired.find(i + 1);
+        check(it != fired.end() && it->second == start + deltas[i],
+              "cascaded timer fired at its tick", deltas[i]);
+    }
+}
+
+void testSameTickAndPast() {
+    TimerWheel wheel(1000);
+    std::vector<TimerWheel::TimerID> expired;
+    wheel.advance(5000, expired);
+    check(expired.empty(), "empty wheel fires nothing");
+
+    // Такт 5000 уже пройден: таймер на нём выдаётся ближайшим advance(),
+    // даже с тем же nowTick.
+    wheel.insert(1, 5000);
+    check(wheel.nextTick() && *wheel.nextTick() <= 5000,
+          "same-tick timer is due now");
+    check(wheel.nextTickIsExpiry(), "same-tick timer is an expiry");
+    wheel.advance(5000, expired);
+    check(expired.size() == 1 && expired[0] == 1, "same-tick timer fired");
+    expired.clear();
+
+    wheel.insert(2, 10);  // Давно прошедший срок
+    wheel.insert(3, 5001);
+    wheel.advance(5000, expired);
+    check(expired.size() == 1 && expired[0] == 2, "past timer fired");
+    check(wheel.size() == 1, "future timer kept", wheel.size());
+    expired.clear();
+    wheel.advance(5001, expired);
+    check(expired.size() == 1 && expired[0] == 3, "next tick timer fired");
+    check(wheel.empty(), "wheel empty");
+}
+
+void testCancel() {
+    // Колесо не снимает таймеры: владелец забывает идентификатор и
+    // пропускает его при срабатывании, как ThreadManager::cancelTimer().
+    TimerWheel wheel(0);
+    std::set<TimerWheel::TimerID> live;
+    for (TimerWheel::TimerID id = 1; id <= 10; ++id) {
+        wheel.insert(id, id * 1000);
+        live.insert(id);
+    }
+    live.erase(3);
+    live.erase(7);
+    std::vector<TimerWheel::TimerID> expired;
+    std::vector<TimerWheel::TimerID> delivered;
+    wheel.advance(100000, expired);
+    for (TimerWheel::TimerID id : expired) {
+        if (live.count(id) != 0) {
+            delivered.push_back(id);
+        }
+    }
+    check(wheel.empty(), "cancelled entries leave the wheel at expiry");
+    check(delivered.size() == 8, "cancelled timers skipped", delivered.size());
+    for (TimerWheel::TimerID id : delivered) {
+        check(id != 3 && id != 7, "cancelled timer delivered", id);
+    }
+}
+
+void testPeriodic() {
+    // Перезапуск как в потоке таймеров: новый срок = старый + период.
+    // Периоды пересекают границы первого и второго уровней.
+    for (uint64_t period : {uint64_t(1), uint64_t(1000), uint64_t(70000)}) {
+        const uint64_t start = 65000;
+        TimerWheel wheel(start);
+        wheel.insert(1, start + period);
+        uint64_t expected = start + period;
+        std::vector<TimerWheel::TimerID> expired;
+        for (int n = 0; n < 300; ++n) {
+            uint64_t tick = *wheel.nextTick();
+            wheel.advance(tick, expired);
+            if (expired.empty()) {
+                continue;  // Перекладка уровней без срабатывания
+            }
+            check(expired.size() == 1 && tick == expected,
+                  "periodic timer fired on schedule", period);
+            expired.clear();
+            expected += period;
+            wheel.insert(1, expected);
+        }
+        check(expected > start + 100 * period, "periodic timer progressed",
+              period);
+    }
+}
+
+void testRandomAgainstModel() {
+    // Случайные вставки и продвижения с фиксированным зерном; модель —
+    // упорядоченное множество сроков.
+    std::mt19937_64 rng(20240601);
+    TimerWheel wheel(123456789);
+    uint64_t now = 123456789;
+    std::multimap<uint64_t, TimerWheel::TimerID> model;
+    TimerWheel::TimerID nextID = 1;
+    std::vector<TimerWheel::TimerID> expired;
+    for (int step = 0; step < 20000; ++step) {
+        int inserts = static_cast<int>(rng() % 4);
+        for (int i = 0; i < inserts; ++i) {
+            uint64_t scale = uint64_t(1) << (rng() % 34);
+            uint64_t expiry = now + rng() % scale;
+            if (rng() % 16 == 0) {
+                expiry = now - rng() % 1000;  // В прошлом
+            }
+            wheel.insert(nextID, expiry);
+            model.emplace(std::max(expiry, now), nextID);
+            ++nextID;
+        }
+        now += rng() % 2 == 0 ? rng() % 300 : rng() % 3000000;
+        expired.clear();
+        wheel.advance(now, expired);
+        std::set<TimerWheel::TimerID> expected;
+        while (!model.empty() && model.begin()->first <= now) {
+            expected.insert(model.begin()->second);
+            model.erase(model.begin());
+        }
+        std::set<TimerWheel::TimerID> got(expired.begin(), expired.end());
+        if (got != expected) {
+            check(false, "random run matches model", static_cast<uint64_t>(step));
+            return;
+        }
+        // Следующий срок из колеса не позже ближайшего в модели.
+        if (!model.empty()) {
+            auto next = wheel.nextTick();
+            check(next && *next <= model.begin()->first,
+                  "nextTick not after earliest expiry", step);
+        }
+    }
+    check(wheel.size() == model.size(), "size matches model", wheel.size());
+}
+
+}  // namespace
+
+int main() {
+    testCascade();
+    testSameTickAndPast();
+    testCancel();
+    testPeriodic();
+    testRandomAgainstModel();
+    if (failures != 0) {
+        std::cerr << failures << " TimerWheel checks failed\n";
+        return 1;
+    }
+    std::cout << "TimerWheel test passed\n";
+    return 0;
+}